@@ -4,8 +4,11 @@
 #include "fourier.hh"
 #include "blitz.hh"
 #include "bits/index.hh"
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 #include <iostream>
+#include <vector>
 #if ARMA_OPENMP
 #include <omp.h>
 #endif
@@ -18,6 +21,10 @@ namespace arma {
 		\brief Multidimensional convolution based on Fourier transform.
 
 		Slicing is done in specified dimension with specified padding.
+		Fourier transform of the kernel is kept between calls and is
+		recomputed only when the kernel changes. Padded blocks are
+		stored in per-thread buffers which are reused by subsequent calls,
+		hence the object must not be used by several threads at once.
 		*/
 		template <class T, int N>
 		class Convolution {
@@ -30,9 +37,28 @@ namespace arma {
 			typedef Fourier_workspace<T,N> workspace_type;
 
 		private:
+			/// Per-thread padded block and Fourier transform workspace.
+			struct Block_buffer {
+
+				array_type part;
+				workspace_type workspace;
+
+				inline explicit
+				Block_buffer(const shape_type& shape):
+				part(shape),
+				workspace(shape)
+				{}
+
+			};
+
 			shape_type _blocksize;
 			shape_type _padding;
 			transform_type _fft;
+			/// The kernel of the last convolution.
+			array_type _kernel;
+			/// Fourier transform of the zero-padded kernel.
+			array_type _spectrum;
+			std::vector<Block_buffer> _buffers;
 
 		public:
 			inline explicit
@@ -64,14 +90,10 @@ namespace arma {
 				if (!all(kernel.shape() <= this->_blocksize)) {
 					throw std::length_error("bad kernel shape");
 				}
-				/// Zero-pad kernel to be of length `block_size + padding`.
 				const shape_type padded_block = this->_blocksize + this->_padding;
-				domain_type orig_domain(shape_type(0), kernel.shape()-1);
-				array_type padded_kernel(padded_block);
-				padded_kernel(orig_domain) = kernel;
-				const T nelements = padded_kernel.numElements();
-				/// Take forward FFT of padded kernel.
-				padded_kernel = this->_fft.forward(padded_kernel);
+				const T nelements = product(padded_block);
+				const array_type& spectrum = this->kernel_spectrum(kernel);
+				this->init_buffers(padded_block);
 				/// Decompose input signal into blocks of length `block_size`.
 				const shape_type bs = this->_blocksize;
 				const shape_type pad = this->_padding;
@@ -82,50 +104,133 @@ namespace arma {
 				if (!all(bs <= limit)) {
 					throw std::length_error("bad block size");
 				}
+				/// Colour the parts so that parts of the same colour do not
+				/// overlap after padding (padding never exceeds block size,
+				/// hence only adjacent parts overlap).
+				const int ncolours = 1 << N;
+				std::vector<std::vector<int>> colours(ncolours);
+				for (int i=0; i<all_parts; ++i) {
+					colours[colour(part_index(i))].push_back(i);
+				}
 				array_type out_signal(limit);
 				#if ARMA_OPENMP
 				#pragma omp parallel
 				#endif
 				{
-					// per-thread workspace
-					workspace_type workspace(padded_block);
 					#if ARMA_OPENMP
-					#pragma omp for schedule(static,1)
+					Block_buffer& buffer = this->_buffers[omp_get_thread_num()];
+					#else
+					Block_buffer& buffer = this->_buffers[0];
 					#endif
-					for (int i=0; i<all_parts; ++i) {
-						/// Zero-pad each part to be of length
-						/// `block_size + padding`.
-						const shape_type idx = part_index(i);
-						const shape_type offset = idx*bs;
-						const shape_type from = offset;
-						const shape_type to = min(limit, offset+bs) - 1;
-						const domain_type part_domain(from, to);
-						const domain_type dom_to(from-offset, to-offset);
-						array_type padded_part(padded_block);
-						padded_part(dom_to) = signal(part_domain);
-						/// Take forward FFT of each padded part.
-						padded_part = this->_fft.forward(padded_part, workspace);
-						/// Multiply two FFTs.
-						padded_part *= padded_kernel;
-						/// Take backward FFT of the result.
-						padded_part = this->_fft.backward(padded_part, workspace);
-						padded_part /= nelements;
-						/// Copy padded part back overlapping it with adjacent parts.
-						const domain_type padded_from(from, min(to+pad, limit-1));
-						const domain_type padded_to(from-offset, padded_from.ubound()-offset);
+					array_type& padded_part = buffer.part;
+					workspace_type& workspace = buffer.workspace;
+					/// Process each colour in a separate phase. Parts of the
+					/// same colour write to disjoint regions of the output,
+					/// so no synchronisation is needed inside a phase.
+					for (int c=0; c<ncolours; ++c) {
+						const std::vector<int>& parts = colours[c];
+						const int nparts_c = parts.size();
 						#if ARMA_OPENMP
-						#pragma omp critical
+						#pragma omp for schedule(static,1)
 						#endif
-						{
+						for (int j=0; j<nparts_c; ++j) {
+							/// Zero-pad each part to be of length
+							/// `block_size + padding`.
+							const shape_type idx = part_index(parts[j]);
+							const shape_type offset = idx*bs;
+							const shape_type from = offset;
+							const shape_type to = min(limit, offset+bs) - 1;
+							const domain_type part_domain(from, to);
+							const domain_type dom_to(from-offset, to-offset);
+							padded_part = T(0);
+							padded_part(dom_to) = signal(part_domain);
+							/// Take forward FFT of each padded part.
+							this->_fft.forward(padded_part, workspace);
+							/// Multiply two FFTs.
+							padded_part *= spectrum;
+							/// Take backward FFT of the result.
+							this->_fft.backward(padded_part, workspace);
+							padded_part /= nelements;
+							/// Add padded part to the output overlapping it
+							/// with adjacent parts of other colours.
+							const domain_type padded_from(from, min(to+pad, limit-1));
+							const domain_type padded_to(from-offset, padded_from.ubound()-offset);
 							out_signal(padded_from) += padded_part(padded_to);
 						}
+						// implicit barrier separates the phases
 					}
 				}
 				return out_signal;
 			}
 
+			/**
+			\brief Estimates the number of floating point operations needed to
+			convolve the signal with the kernel of the specified shapes.
+
+			Counts forward and backward complex transforms
+			(\f$5n\log_2 n\f$ each) and pointwise multiplication
+			for every padded block.
+			*/
+			inline static double
+			cost(const shape_type& signal_shape, const shape_type& kernel_shape) {
+				const shape_type bs = get_block_shape(signal_shape, kernel_shape);
+				double nblocks = 1, n = 1;
+				for (int i=0; i<N; ++i) {
+					nblocks *= blitz::div_ceil(signal_shape(i), bs(i));
+					n *= bs(i) + kernel_shape(i);
+				}
+				return nblocks*(10.0*n*std::log2(n) + 6.0*n);
+			}
+
 		private:
 
+			/**
+			Returns forward Fourier transform of the kernel zero-padded to
+			be of length `block_size + padding`. The transform is
+			recomputed only if the kernel differs from the previous one.
+			*/
+			const array_type&
+			kernel_spectrum(const array_type& kernel) {
+				using blitz::all;
+				if (this->_spectrum.numElements() > 0 &&
+					all(this->_kernel.shape() == kernel.shape()) &&
+					all(this->_kernel == kernel))
+				{
+					return this->_spectrum;
+				}
+				const shape_type padded_block = this->_blocksize + this->_padding;
+				const domain_type orig_domain(shape_type(0), kernel.shape()-1);
+				this->_spectrum.resize(padded_block);
+				this->_spectrum = T(0);
+				this->_spectrum(orig_domain) = kernel;
+				this->_fft.forward(this->_spectrum);
+				this->_kernel.resize(kernel.shape());
+				this->_kernel = kernel;
+				return this->_spectrum;
+			}
+
+			/// Allocates padded block buffer for each thread.
+			void
+			init_buffers(const shape_type& padded_block) {
+				#if ARMA_OPENMP
+				const int nthreads = std::max(1, omp_get_max_threads());
+				#else
+				const int nthreads = 1;
+				#endif
+				while (int(this->_buffers.size()) < nthreads) {
+					this->_buffers.emplace_back(padded_block);
+				}
+			}
+
+			inline static int
+			colour(const shape_type& idx) noexcept {
+				int result = 0;
+				for (int i=0; i<N; ++i) {
+					result |= (idx(i) % 2) << i;
+				}
+				return result;
+			}
+
 			inline void
 			check() {
 				using blitz::all;
@@ -140,7 +245,7 @@ namespace arma {
 				}
 			}
 
-			inline shape_type
+			inline static shape_type
 			get_block_shape(
 				const shape_type& signal_shape,
 				const shape_type& kernel_shape
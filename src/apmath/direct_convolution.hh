@@ -0,0 +1,221 @@
+#ifndef APMATH_DIRECT_CONVOLUTION_HH
+#define APMATH_DIRECT_CONVOLUTION_HH
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#if ARMA_OPENMP
+#include <omp.h>
+#endif
+
+#include "blitz.hh"
+#include "types.hh"
+
+namespace arma {
+
+	namespace apmath {
+
+		/**
+		\brief Causal three-dimensional convolution computed directly
+		without Fourier transforms.
+
+		Computes
+		\f[
+			y_{t,x,y} = \sum\limits_{i=0}^{n_1-1}
+			\sum\limits_{j=0}^{n_2-1}
+			\sum\limits_{k=0}^{n_3-1}
+			K_{i,j,k} s_{t-i,x-j,y-k}
+		\f]
+		assuming that the signal \f$s\f$ equals nought outside of its
+		domain. This is the same result that \link Convolution \endlink
+		produces, but for small or degenerate kernels (e.g. one-dimensional
+		kernels of MA models with order \f$(n,1,1)\f$) direct summation is
+		cheaper than Fourier transforms. If the kernel is separable, i.e.
+		\f$K_{i,j,k}=a_i b_j c_k\f$, convolution is done in three
+		one-dimensional passes.
+		*/
+		template <class T>
+		class Direct_convolution {
+
+		public:
+			typedef Array3D<T> array_type;
+			typedef Shape3D shape_type;
+
+		private:
+			array_type _kernel;
+			/// One-dimensional factors of the separable kernel.
+			array_type _factors[3];
+			bool _separable = false;
+
+		public:
+
+			/**
+			\param[in] kernel convolution kernel
+			\param[in] eps relative tolerance of separable factorisation
+			*/
+			inline explicit
+			Direct_convolution(
+				array_type kernel,
+				T eps=std::sqrt(std::numeric_limits<T>::epsilon())
+			):
+			_kernel(kernel)
+			{ this->factorise(eps); }
+
+			/// Whether the kernel is a product of one-dimensional kernels.
+			inline bool
+			separable() const noexcept {
+				return this->_separable;
+			}
+
+			/// The number of multiply-add operations per output point.
+			inline int
+			taps() const {
+				return this->uses_factors()
+					? blitz::sum(this->_kernel.shape())
+					: blitz::count(this->_kernel != T(0));
+			}
+
+			/**
+			\brief Estimates the number of floating point operations needed to
+			convolve the signal of the specified shape.
+			*/
+			inline double
+			cost(const shape_type& signal_shape) const {
+				double n = 1;
+				for (int i=0; i<3; ++i) {
+					n *= signal_shape(i);
+				}
+				return 2.0*n*this->taps();
+			}
+
+			inline array_type
+			convolve(const array_type& signal) const {
+				array_type result(signal.shape());
+				this->convolve(signal, result);
+				return result;
+			}
+
+			void
+			convolve(const array_type& signal, array_type& result) const {
+				if (this->uses_factors()) {
+					array_type tmp(signal.shape());
+					stencil(signal, this->_factors[2], result);
+					stencil(result, this->_factors[1], tmp);
+					stencil(tmp, this->_factors[0], result);
+				} else {
+					stencil(signal, this->_kernel, result);
+				}
+			}
+
+		private:
+
+			/// Separable convolution is cheaper than the direct one.
+			inline bool
+			uses_factors() const {
+				return this->_separable &&
+					blitz::sum(this->_kernel.shape()) <
+					blitz::count(this->_kernel != T(0));
+			}
+
+			/**
+			Tries to represent the kernel as a product of three
+			one-dimensional kernels taking the slices through its
+			largest element.
+			*/
+			void
+			factorise(T eps) {
+				using blitz::abs;
+				using blitz::maxIndex;
+				const array_type& k = this->_kernel;
+				if (k.numElements() == 0) {
+					return;
+				}
+				const shape_type p = maxIndex(abs(k));
+				const T pivot = k(p);
+				if (pivot == T(0)) {
+					return;
+				}
+				const int n0 = k.extent(0);
+				const int n1 = k.extent(1);
+				const int n2 = k.extent(2);
+				array_type a(shape_type(n0,1,1));
+				array_type b(shape_type(1,n1,1));
+				array_type c(shape_type(1,1,n2));
+				for (int i=0; i<n0; ++i) { a(i,0,0) = k(i,p(1),p(2)); }
+				for (int j=0; j<n1; ++j) { b(0,j,0) = k(p(0),j,p(2)) / pivot; }
+				for (int l=0; l<n2; ++l) { c(0,0,l) = k(p(0),p(1),l) / pivot; }
+				const T tolerance = eps*std::abs(pivot);
+				for (int i=0; i<n0; ++i) {
+					for (int j=0; j<n1; ++j) {
+						for (int l=0; l<n2; ++l) {
+							const T approx = a(i,0,0)*b(0,j,0)*c(0,0,l);
+							if (!(std::abs(k(i,j,l) - approx) <= tolerance)) {
+								return;
+							}
+						}
+					}
+				}
+				this->_factors[0].reference(a);
+				this->_factors[1].reference(b);
+				this->_factors[2].reference(c);
+				this->_separable = true;
+			}
+
+			/**
+			Computes the convolution for each \f$(t,x)\f$ row separately.
+			The innermost loop runs over contiguous \f$y\f$ elements of the
+			signal and the result and is vectorised.
+			*/
+			static void
+			stencil(
+				const array_type& signal,
+				const array_type& kernel,
+				array_type& result
+			) {
+				assert(signal.isStorageContiguous());
+				assert(result.isStorageContiguous());
+				assert(signal.stride(2) == 1 && result.stride(2) == 1);
+				const int nt = signal.extent(0);
+				const int nx = signal.extent(1);
+				const int ny = signal.extent(2);
+				const int kt = kernel.extent(0);
+				const int kx = kernel.extent(1);
+				const int ky = std::min(kernel.extent(2), ny);
+				#if ARMA_OPENMP
+				#pragma omp parallel for collapse(2) schedule(static)
+				#endif
+				for (int t=0; t<nt; ++t) {
+					for (int x=0; x<nx; ++x) {
+						T* out = &result(t,x,0);
+						std::fill_n(out, ny, T(0));
+						const int mt = std::min(t+1, kt);
+						const int mx = std::min(x+1, kx);
+						for (int i=0; i<mt; ++i) {
+							for (int j=0; j<mx; ++j) {
+								const T* in = &signal(t-i,x-j,0);
+								for (int l=0; l<ky; ++l) {
+									const T w = kernel(i,j,l);
+									if (w == T(0)) {
+										continue;
+									}
+									#if ARMA_OPENMP
+									#pragma omp simd
+									#endif
+									for (int y=l; y<ny; ++y) {
+										out[y] += w*in[y-l];
+									}
+								}
+							}
+						}
+					}
+				}
+			}
+
+		};
+
+	}
+
+}
+
+#endif // APMATH_DIRECT_CONVOLUTION_HH
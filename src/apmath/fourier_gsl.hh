@@ -3,6 +3,9 @@
 
 #include <complex>
 #include <vector>
+#if ARMA_OPENMP
+#include <omp.h>
+#endif
 
 #include "apmath/fourier_direction.hh"
 #include "bits/fourier_gsl.hh"
@@ -117,8 +120,7 @@ namespace arma {
 
 			inline array_type
 			forward(array_type rhs) {
-				workspace_type ws(this->new_workspace());
-				return transform(rhs, ws, apmath::Fourier_direction::Forward);
+				return transform(rhs, apmath::Fourier_direction::Forward);
 			}
 
 			inline array_type
@@ -128,8 +130,7 @@ namespace arma {
 
 			inline array_type
 			backward(array_type rhs) {
-				workspace_type ws(this->new_workspace());
-				return transform(rhs, ws, apmath::Fourier_direction::Backward);
+				return transform(rhs, apmath::Fourier_direction::Backward);
 			}
 
 			inline array_type
@@ -183,6 +184,47 @@ namespace arma {
 				return rhs;
 			}
 
+			/**
+			Transforms the array using all available threads.
+			One-dimensional transforms along each dimension are independent,
+			hence they are distributed between threads each having its own
+			workspace. When called from a parallel region, the transform is
+			done by the calling thread only.
+			*/
+			inline array_type
+			transform(array_type rhs, apmath::Fourier_direction dir) {
+				const int n = this->_transforms.size();
+				for (int i = 0; i < n; ++i) {
+					const int stride = rhs.stride(i);
+					const int extent = rhs.extent(i);
+					const int block_size = extent*stride;
+					const int nlines = rhs.numElements() / extent;
+					#if ARMA_OPENMP
+					#pragma omp parallel if(!omp_in_parallel())
+					#endif
+					{
+						workspace_type workspace(this->new_workspace());
+						#if ARMA_OPENMP
+						#pragma omp for schedule(static)
+						#endif
+						for (int l=0; l<nlines; ++l) {
+							const int k = l / stride;
+							const int j = l % stride;
+							const int offset = block_size*k + j;
+							this->_transforms[i].transform(
+								rhs.data()+offset,
+								stride,
+								dir == apmath::Fourier_direction::Forward
+								? gsl_fft_forward
+								: gsl_fft_backward,
+								workspace[i]
+							);
+						}
+					}
+				}
+				return rhs;
+			}
+
 			inline workspace_type
 			new_workspace() const {
 				return workspace_type(this->shape());
@@ -55,5 +55,43 @@ arma::apmath::owen_t(T h, T alpha)
 	return result * alpha / _2pi<T>;
 }
 
+template <class T>
+void
+arma::apmath::owen_t(const T* h, T alpha, T* result, int n) {
+	using namespace arma::constants;
+	using std::exp;
+	const T a2 = alpha*alpha;
+	const T factor = alpha / _2pi<T>;
+	for (int j=0; j<n; ++j) {
+		result[j] = 0;
+	}
+	for (int i=0; i<nabscissas; ++i) {
+		const T x = abscissas<T>[i];
+		const T term = (T(1) + a2*x*x);
+		const T w = weights<T>[i] / term;
+		const T c = T(-0.5)*term;
+		#if ARMA_OPENMP
+		#pragma omp simd
+		#endif
+		for (int j=0; j<n; ++j) {
+			result[j] += w * exp(c*h[j]*h[j]);
+		}
+	}
+	#if ARMA_OPENMP
+	#pragma omp simd
+	#endif
+	for (int j=0; j<n; ++j) {
+		result[j] *= factor;
+	}
+}
+
 template ARMA_REAL_TYPE
 arma::apmath::owen_t(ARMA_REAL_TYPE x, ARMA_REAL_TYPE alpha);
+
+template void
+arma::apmath::owen_t(
+	const ARMA_REAL_TYPE* h,
+	ARMA_REAL_TYPE alpha,
+	ARMA_REAL_TYPE* result,
+	int n
+);
@@ -34,6 +34,17 @@ namespace arma {
 		T
 		owen_t(T h, T alpha);
 
+		/**
+		\brief Computes Owen's \f$T\f$-function for each of \f$n\f$ values
+		of \f$h\f$.
+
+		The outer loop is over abscissas and the inner loop is over
+		the points, so that the inner loop is vectorised.
+		*/
+		template <class T>
+		void
+		owen_t(const T* h, T alpha, T* result, int n);
+
 	}
 
 }
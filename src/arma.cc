@@ -4,13 +4,197 @@
 #include <fstream>
 #endif
 
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <limits>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include <gsl/gsl_complex.h>
 #include <gsl/gsl_errno.h>
 #include <gsl/gsl_poly.h>
 
 #include "fourier.hh"
+#include "physical_constants.hh"
+#include "util.hh"
+
+namespace {
+
+	template <class T>
+	using frequency_type = blitz::TinyVector<T,3>;
+
+	/**
+	Evaluates modulus of \f$P(\omega)=\sum a_{i,j,k}
+	e^{-\mathrm{i}\left(\omega_1 i + \omega_2 j + \omega_3 k\right)}\f$
+	directly. The sum is separated into nested sums over each dimension
+	to compute complex exponents only once.
+	*/
+	template <class T>
+	T
+	polynomial_modulus(const arma::Array3D<T>& a, const frequency_type<T>& w) {
+		typedef std::complex<T> C;
+		const int n0 = a.extent(0);
+		const int n1 = a.extent(1);
+		const int n2 = a.extent(2);
+		std::vector<C> e0(n0), e1(n1), e2(n2);
+		for (int i=0; i<n0; ++i) { e0[i] = std::polar(T(1), -w(0)*i); }
+		for (int j=0; j<n1; ++j) { e1[j] = std::polar(T(1), -w(1)*j); }
+		for (int k=0; k<n2; ++k) { e2[k] = std::polar(T(1), -w(2)*k); }
+		C sum(0);
+		for (int i=0; i<n0; ++i) {
+			C sum_i(0);
+			for (int j=0; j<n1; ++j) {
+				C sum_j(0);
+				for (int k=0; k<n2; ++k) {
+					sum_j += a(i,j,k)*e2[k];
+				}
+				sum_i += sum_j*e1[j];
+			}
+			sum += sum_i*e0[i];
+		}
+		return std::abs(sum);
+	}
+
+	/// The result of the search for zeros in the cell.
+	enum struct Cell_status {
+		/// The modulus is bounded away from nought in the whole cell.
+		no_zeros = 0,
+		/// The number of evaluations exceeded the budget.
+		undecided = 1,
+		/// The modulus is not larger than the rounding error.
+		zero = 2
+	};
+
+	/**
+	Searches for zeros of the polynomial in the cell with the centre \p w
+	and half-widths \p h, where \p value is the modulus in the centre.
+	The cell contains no zeros if the value is larger than the Lipschitz
+	constants multiplied by the half-widths, otherwise the cell is split
+	in halves along each dimension and the sub-cells are checked
+	recursively starting from the one with the smallest modulus. Each
+	evaluation of the polynomial decrements \p budget, and the search
+	stops when the budget is exhausted. The minimal modulus is stored in
+	\p min_value.
+	*/
+	template <class T>
+	Cell_status
+	subdivide_cell(
+		const arma::Array3D<T>& a,
+		const frequency_type<T>& w,
+		const frequency_type<T>& h,
+		const frequency_type<T>& lipschitz,
+		T value,
+		T tolerance,
+		long& budget,
+		T& min_value
+	) {
+		typedef std::pair<T,frequency_type<T>> cell_type;
+		min_value = std::min(min_value, value);
+		if (!(value > tolerance)) {
+			return Cell_status::zero;
+		}
+		if (value > blitz::sum(lipschitz*h)) {
+			return Cell_status::no_zeros;
+		}
+		int ndims = 0;
+		for (int l=0; l<3; ++l) {
+			if (h(l) > T(0)) {
+				++ndims;
+			}
+		}
+		if (budget < (1L << ndims)) {
+			return Cell_status::undecided;
+		}
+		const frequency_type<T> h1(h / T(2));
+		cell_type cells[8];
+		int ncells = 0;
+		for (int i=-1; i<=1; i+=2) {
+			for (int j=-1; j<=1; j+=2) {
+				for (int k=-1; k<=1; k+=2) {
+					if ((i > 0 && h(0) == T(0)) ||
+						(j > 0 && h(1) == T(0)) ||
+						(k > 0 && h(2) == T(0))) {
+						continue;
+					}
+					const frequency_type<T> w1(w + frequency_type<T>(i,j,k)*h1);
+					cells[ncells++] = cell_type(polynomial_modulus(a, w1), w1);
+				}
+			}
+		}
+		budget -= ncells;
+		std::sort(
+			cells,
+			cells + ncells,
+			[] (const cell_type& lhs, const cell_type& rhs) {
+				return lhs.first < rhs.first;
+			}
+		);
+		Cell_status result = Cell_status::no_zeros;
+		for (int n=0; n<ncells; ++n) {
+			const Cell_status status = subdivide_cell(
+				a,
+				cells[n].second,
+				h1,
+				lipschitz,
+				cells[n].first,
+				tolerance,
+				budget,
+				min_value
+			);
+			if (status == Cell_status::zero) {
+				return status;
+			}
+			if (status == Cell_status::undecided) {
+				result = status;
+			}
+		}
+		return result;
+	}
+
+	/// Returns the number of roots of the polynomial that lie inside or
+	/// on the unit circle.
+	int
+	count_roots_inside_unit_circle(blitz::Array<double,1> coefficients) {
+		typedef blitz::Array<std::complex<double>,1> result_type;
+		int n = coefficients.numElements();
+		while (n > 1 && coefficients(n-1) == 0.0) {
+			--n;
+		}
+		if (n <= 1) {
+			return 0;
+		}
+		result_type roots(n-1);
+		gsl_poly_complex_workspace* w = gsl_poly_complex_workspace_alloc(n);
+		int ret = gsl_poly_complex_solve(
+			coefficients.data(),
+			n,
+			w,
+			(gsl_complex_packed_ptr)roots.data()
+		);
+		gsl_poly_complex_workspace_free(w);
+		if (ret != GSL_SUCCESS) {
+			std::cerr << "GSL error: " << gsl_strerror(ret) << '.' << std::endl;
+			throw std::runtime_error(
+					  "Can not find roots of the polynomial to "
+					  "verify AR/MA model stationarity/invertibility."
+			);
+		}
+		int num_bad_roots = 0;
+		for (int i=0; i<n-1; ++i) {
+			const double val = std::abs(roots(i));
+			if (!(val > 1.0)) {
+				++num_bad_roots;
+				std::cerr << "Root #" << i << '=' << roots(i)
+					<< " abs=" << val << std::endl;
+			}
+		}
+		return num_bad_roots;
+	}
+
+}
 
 template <class T, int N>
 void
@@ -69,6 +253,142 @@ arma
 	}
 }
 
+template <class T>
+void
+arma
+::validate_process_on_torus(const Array3D<T>& phi) {
+	using blitz::abs;
+	using blitz::sum;
+	typedef std::complex<T> C;
+	if (blitz::product(phi.shape()) <= 1) {
+		return;
+	}
+	/// 1. Coefficients of the polynomial \f$P(z)=1-\sum\varphi z^p\f$.
+	const Shape3D order = phi.shape();
+	Array3D<T> a(order);
+	a = -phi;
+	a(0,0,0) = 1;
+	/// 2. Evaluate \f$P\f$ on the frequency grid with four points
+	/// per coefficient along each dimension on which it depends.
+	Shape3D grid_shape;
+	for (int l=0; l<3; ++l) {
+		grid_shape(l) = order(l) == 1 ? 1 : std::max(16, 4*order(l));
+	}
+	Array3D<C> values(grid_shape);
+	values = C(0);
+	values(blitz::RectDomain<3>(Shape3D(0,0,0), order-1)) = a;
+	apmath::Fourier_transform<C,3> fft(grid_shape);
+	fft.forward(values);
+	Array3D<T> modulus(grid_shape);
+	modulus = abs(values);
+	values.free();
+	/// 3. Lipschitz constants of \f$P\f$ along each frequency axis.
+	frequency_type<T> lipschitz(0,0,0);
+	for (int i=0; i<order(0); ++i) {
+		for (int j=0; j<order(1); ++j) {
+			for (int k=0; k<order(2); ++k) {
+				const T v = std::abs(a(i,j,k));
+				lipschitz(0) += v*i;
+				lipschitz(1) += v*j;
+				lipschitz(2) += v*k;
+			}
+		}
+	}
+	/// 4. Grid cell may contain zero only if the modulus in its centre
+	/// is not larger than the Lipschitz constants multiplied by cell
+	/// half-widths. Every such cell is subdivided until it is proved to
+	/// contain no zeros or the budget is exhausted.
+	frequency_type<T> h;
+	for (int l=0; l<3; ++l) {
+		h(l) = order(l) == 1 ? T(0) : constants::pi<T> / grid_shape(l);
+	}
+	const T threshold = sum(lipschitz*h);
+	std::vector<Shape3D> cells;
+	for (int i=0; i<grid_shape(0); ++i) {
+		for (int j=0; j<grid_shape(1); ++j) {
+			for (int k=0; k<grid_shape(2); ++k) {
+				if (!(modulus(i,j,k) > threshold)) {
+					cells.emplace_back(i,j,k);
+				}
+			}
+		}
+	}
+	/// 5. The modulus is compared to the bound of the rounding error
+	/// of the polynomial evaluation, which is proportional to the
+	/// number of terms and the sum of coefficients moduli, plus the error
+	/// due to the rounding of the frequencies. The total number of
+	/// evaluations of the polynomial is bounded and is evenly distributed
+	/// between the cells, so that the result does not depend on the
+	/// number of threads.
+	const T eps = std::numeric_limits<T>::epsilon();
+	const T tolerance = eps*(
+		T(blitz::product(order))*sum(abs(a))
+		+ constants::_2pi<T>*sum(lipschitz)
+	);
+	const int ncells = cells.size();
+	const long max_evaluations = (1L << 26) / blitz::product(order);
+	const long cell_budget = ncells == 0 ? 0 : max_evaluations / ncells;
+	T min_modulus = blitz::min(modulus);
+	int status = int(Cell_status::no_zeros);
+	#if ARMA_OPENMP
+	#pragma omp parallel for schedule(dynamic) \
+		reduction(min:min_modulus) reduction(max:status)
+	#endif
+	for (int n=0; n<ncells; ++n) {
+		const Shape3D& c = cells[n];
+		frequency_type<T> w;
+		for (int l=0; l<3; ++l) {
+			w(l) = constants::_2pi<T>*c(l) / grid_shape(l);
+		}
+		long budget = cell_budget;
+		const Cell_status s = subdivide_cell(
+			a,
+			w,
+			h,
+			lipschitz,
+			modulus(c(0),c(1),c(2)),
+			tolerance,
+			budget,
+			min_modulus
+		);
+		status = std::max(status, int(s));
+	}
+	write_key_value(std::clog, "Min. char. polynomial modulus", min_modulus);
+	if (status == int(Cell_status::zero)) {
+		std::cerr << "Min. modulus = " << min_modulus
+			<< ", tolerance = " << tolerance << std::endl;
+		throw std::runtime_error(
+				  "AR/MA process is not stationary/invertible: "
+				  "characteristic polynomial has zeros on unit torus."
+		);
+	}
+	if (status == int(Cell_status::undecided)) {
+		std::clog << "Warning: can not prove that characteristic polynomial "
+			"has no zeros on unit torus within " << max_evaluations
+			<< " evaluations, min. modulus = " << min_modulus
+			<< ". Checking roots of the diagonal polynomial only."
+			<< std::endl;
+	}
+	/// 6. Check roots of \f$P(z,z,z)\f$.
+	blitz::Array<double,1> diagonal(blitz::sum(order-1) + 1);
+	diagonal = 0;
+	for (int i=0; i<order(0); ++i) {
+		for (int j=0; j<order(1); ++j) {
+			for (int k=0; k<order(2); ++k) {
+				diagonal(i+j+k) += a(i,j,k);
+			}
+		}
+	}
+	const int num_bad_roots = count_roots_inside_unit_circle(diagonal);
+	if (num_bad_roots > 0) {
+		std::cerr << "No. of bad roots = " << num_bad_roots << std::endl;
+		throw std::runtime_error(
+				  "AR/MA process is not stationary/invertible: some roots lie "
+				  "inside unit circle or on its borderline."
+		);
+	}
+}
+
 template <class T>
 T
 arma
@@ -103,6 +423,10 @@ template void
 arma
 ::validate_process<ARMA_REAL_TYPE,3>(blitz::Array<ARMA_REAL_TYPE,3> _phi);
 
+template void
+arma
+::validate_process_on_torus<ARMA_REAL_TYPE>(const Array3D<ARMA_REAL_TYPE>& phi);
+
 template ARMA_REAL_TYPE
 arma
 ::MA_white_noise_variance(
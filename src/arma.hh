@@ -15,6 +15,27 @@ namespace arma {
 	void
 	validate_process(blitz::Array<T, N> _phi);
 
+	/**
+	\brief Check AR (MA) process stationarity (invertibility)
+	without finding roots of the flattened polynomial.
+
+	The process is stationary if the characteristic polynomial
+	\f$P(z)=1-\sum\varphi_{i,j,k}z_1^i z_2^j z_3^k\f$ has no zeros in
+	the closed unit polydisc. This is true if and only if
+	\f$P(z)\neq0\f$ on the unit torus \f$|z_1|=|z_2|=|z_3|=1\f$ and
+	\f$P(z,z,z)\neq0\f$ for \f$|z|\leq1\f$ \cite DeCarlo1977.
+	The first condition is checked by evaluating \f$P\f$ on a uniform
+	frequency grid with the FFT and recursively subdividing every cell in
+	which the modulus is not bounded away from nought by the Lipschitz
+	constant of \f$P\f$. The number of subdivisions is bounded, and if
+	the check is undecided within the bound, a warning is printed.
+	The second condition is checked by finding roots of the
+	one-dimensional polynomial, which degree is the sum of the orders.
+	*/
+	template <class T>
+	void
+	validate_process_on_torus(const Array3D<T>& phi);
+
 	template <class T>
 	T
 	ACF_variance(const Array3D<T>& acf) {
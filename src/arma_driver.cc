@@ -73,6 +73,11 @@ void
 arma::ARMA_driver<T>::generate_wavy_surface() {
 	this->echo_parameters();
 	this->_zeta.reference(this->_model->generate());
+	if (this->_model->generates_in_blocks()) {
+		std::clog << "Wavy surface is generated block by block, "
+			"verification and velocity potentials are skipped." << std::endl;
+		return;
+	}
 	this->_zeta.setgrid(this->wavy_surface_grid());
 	#if ARMA_OPENCL
 	this->_zeta.copy_to_host_if_exists();
@@ -83,6 +88,9 @@ arma::ARMA_driver<T>::generate_wavy_surface() {
 template <class T>
 void
 arma::ARMA_driver<T>::compute_velocity_potentials() {
+	if (this->_model->generates_in_blocks()) {
+		return;
+	}
 	this->_vpotentials.reference(_solver->operator()(_zeta));
 }
 
@@ -122,7 +130,9 @@ template <class T>
 void
 arma::ARMA_driver<T>::write_all() {
 	ARMA_PROFILE_START(write_all);
-	if (this->oflags().isset(Output_flags::Surface)) {
+	/// The blocks are already written to the binary file.
+	if (this->oflags().isset(Output_flags::Surface) &&
+		!this->_model->generates_in_blocks()) {
 		this->write_wavy_surface();
 		this->write_velocity_potentials();
 	}
@@ -0,0 +1,207 @@
+#include "conjugate_gradient.hh"
+
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+#include "profile.hh"
+#include "util.hh"
+
+namespace {
+
+	template <class T>
+	inline T
+	dot(const arma::Array3D<T>& lhs, const arma::Array3D<T>& rhs) {
+		return blitz::sum(lhs*rhs);
+	}
+
+	template <class T>
+	inline T
+	norm(const arma::Array3D<T>& rhs) {
+		return std::sqrt(dot(rhs, rhs));
+	}
+
+}
+
+template <class T>
+arma::Conjugate_gradient_solver<T>
+::Conjugate_gradient_solver(array_type acf, Shape3D order):
+_acf(acf),
+_order(order) {
+	using blitz::all;
+	if (!all(order > 0) || !all(order <= acf.shape())) {
+		throw std::invalid_argument("bad AR model order");
+	}
+}
+
+template <class T>
+void
+arma::Conjugate_gradient_solver<T>
+::init_spectrum() {
+	/// Extend the ACF to the torus of twice the order size
+	/// assuming that it is symmetric along each dimension.
+	const Shape3D shape = 2*this->_order;
+	complex_array_type spectrum(shape);
+	spectrum = complex_type(0);
+	for (int i=0; i<this->_order(0); ++i) {
+		for (int j=0; j<this->_order(1); ++j) {
+			for (int k=0; k<this->_order(2); ++k) {
+				const T r = this->_acf(i,j,k);
+				for (int i1 : {i, (shape(0)-i) % shape(0)}) {
+					for (int j1 : {j, (shape(1)-j) % shape(1)}) {
+						for (int k1 : {k, (shape(2)-k) % shape(2)}) {
+							spectrum(i1,j1,k1) = r;
+						}
+					}
+				}
+			}
+		}
+	}
+	this->_fft_matrix.init(shape);
+	this->_fft_matrix.forward(spectrum);
+	this->_spectrum.reference(spectrum);
+}
+
+template <class T>
+void
+arma::Conjugate_gradient_solver<T>
+::init_preconditioner() {
+	using blitz::max;
+	using blitz::real;
+	using blitz::where;
+	const Shape3D& n = this->_order;
+	/**
+	Element \f$c_{d}\f$ of the circulant is the weighted sum of
+	\f$\gamma_{s}\f$ over all \f$s_l\in\{d_l,n_l-d_l\}\f$ with weights
+	\f$(n_l-d_l)/n_l\f$ and \f$d_l/n_l\f$ respectively.
+	*/
+	complex_array_type c(n);
+	c = complex_type(0);
+	for (int i=0; i<n(0); ++i) {
+		for (int j=0; j<n(1); ++j) {
+			for (int k=0; k<n(2); ++k) {
+				const Shape3D d(i,j,k);
+				T sum = 0;
+				for (int mask=0; mask<8; ++mask) {
+					T w = 1;
+					Shape3D lag;
+					for (int l=0; l<3; ++l) {
+						if (mask & (1<<l)) {
+							w *= T(d(l)) / T(n(l));
+							lag(l) = n(l) - d(l);
+						} else {
+							w *= T(n(l) - d(l)) / T(n(l));
+							lag(l) = d(l);
+						}
+					}
+					if (w != T(0)) {
+						sum += w*this->_acf(lag);
+					}
+				}
+				c(i,j,k) = sum;
+			}
+		}
+	}
+	this->_fft_preconditioner.init(n);
+	this->_fft_preconditioner.forward(c);
+	this->_eigenvalues.resize(n);
+	this->_eigenvalues = real(c);
+	/// Eigenvalues are positive for positive definite matrix,
+	/// clip them to be safe.
+	const T eps = T(1e-12)*max(this->_eigenvalues);
+	this->_eigenvalues = where(
+		this->_eigenvalues > eps,
+		this->_eigenvalues,
+		eps
+	);
+}
+
+template <class T>
+typename arma::Conjugate_gradient_solver<T>::array_type
+arma::Conjugate_gradient_solver<T>
+::multiply(const array_type& x) {
+	using blitz::real;
+	const blitz::RectDomain<3> domain(Shape3D(0,0,0), this->_order-1);
+	complex_array_type tmp(this->_spectrum.shape());
+	tmp = complex_type(0);
+	tmp(domain) = x;
+	this->_fft_matrix.forward(tmp);
+	tmp *= this->_spectrum;
+	this->_fft_matrix.backward(tmp);
+	array_type result(this->_order);
+	result = real(tmp(domain)) / T(tmp.numElements());
+	return result;
+}
+
+template <class T>
+typename arma::Conjugate_gradient_solver<T>::array_type
+arma::Conjugate_gradient_solver<T>
+::precondition(const array_type& r) {
+	using blitz::real;
+	complex_array_type tmp(this->_order);
+	tmp = r;
+	this->_fft_preconditioner.forward(tmp);
+	tmp /= this->_eigenvalues;
+	this->_fft_preconditioner.backward(tmp);
+	array_type result(this->_order);
+	result = real(tmp) / T(tmp.numElements());
+	return result;
+}
+
+template <class T>
+typename arma::Conjugate_gradient_solver<T>::array_type
+arma::Conjugate_gradient_solver<T>
+::solve() {
+	ARMA_PROFILE_START(conjugate_gradient);
+	this->init_spectrum();
+	this->init_preconditioner();
+	const int max_iterations = this->_maxiterations > 0
+		? this->_maxiterations
+		: blitz::product(this->_order);
+	/// Solve \f$\Gamma x = e_0\f$ starting with \f$x=0\f$.
+	array_type x(this->_order);
+	x = 0;
+	array_type r(this->_order);
+	r = 0;
+	r(0,0,0) = 1;
+	array_type z = this->precondition(r);
+	array_type p(z.copy());
+	T rz = dot(r, z);
+	T residual = norm(r);
+	int k = 0;
+	while (k < max_iterations) {
+		const array_type q = this->multiply(p);
+		const T alpha = rz / dot(p, q);
+		x += alpha*p;
+		r -= alpha*q;
+		residual = norm(r);
+		++k;
+		if (residual < this->_residual) {
+			break;
+		}
+		z.reference(this->precondition(r));
+		const T rz_new = dot(r, z);
+		p = z + (rz_new/rz)*p;
+		rz = rz_new;
+	}
+	this->_niterations = k;
+	ARMA_PROFILE_END(conjugate_gradient);
+	write_key_value(std::clog, "CG iterations", k);
+	write_key_value(std::clog, "CG residual", residual);
+	if (!(residual < this->_residual)) {
+		std::cerr << "Residual " << residual
+			<< " is larger than " << this->_residual
+			<< " after " << k << " iterations" << std::endl;
+		throw std::runtime_error("conjugate gradient method did not converge");
+	}
+	if (!(x(0,0,0) > T(0))) {
+		throw std::runtime_error("autocovariance matrix is not positive definite");
+	}
+	array_type phi(this->_order);
+	phi = -x / x(0,0,0);
+	phi(0,0,0) = 0;
+	this->_varwn = T(1) / x(0,0,0);
+	return phi;
+}
+
+template class arma::Conjugate_gradient_solver<ARMA_REAL_TYPE>;
@@ -0,0 +1,145 @@
+#ifndef CONJUGATE_GRADIENT_HH
+#define CONJUGATE_GRADIENT_HH
+
+#include <complex>
+
+#include "fourier.hh"
+#include "types.hh"
+
+namespace arma {
+
+	/**
+	\brief
+	Computes AR model coefficients using preconditioned conjugate gradient
+	method.
+
+	The autocovariance matrix of the Yule---Walker system is never stored.
+	Its product with a vector is three-dimensional correlation with the ACF,
+	which is computed with Fourier transforms by embedding the ACF into
+	a torus twice as large as the AR model order. The preconditioner is
+	optimal multilevel circulant approximation of the matrix
+	\cite Chan1988, it is inverted with Fourier transforms of the size of
+	the order. Each iteration takes \f$O(n\log n)\f$ operations, where
+	\f$n\f$ is the number of coefficients.
+
+	The system \f$\Gamma a = e_0\f$ is solved, where \f$\Gamma\f$ is
+	the full autocovariance matrix, and the coefficients are
+	\f$\varphi=-a/a_0\f$.
+	*/
+	template <class T>
+	class Conjugate_gradient_solver {
+
+	public:
+		/// Array element type.
+		typedef T value_type;
+		/// Three-dimensional array type.
+		typedef Array3D<T> array_type;
+
+	private:
+		typedef std::complex<T> complex_type;
+		typedef Array3D<complex_type> complex_array_type;
+		typedef apmath::Fourier_transform<complex_type,3> transform_type;
+
+		/// Three-dimensional auto-covariance function \f$\gamma\f$.
+		array_type _acf;
+		/// AR model order.
+		Shape3D _order;
+		/// Maximal relative residual \f$\|r\|/\|e_0\|\f$.
+		T _residual = T(1e-10);
+		/// Maximal number of iterations.
+		int _maxiterations = 0;
+		/// The number of iterations made by the last call to \link solve\endlink.
+		int _niterations = 0;
+		/// White noise variance, calculated by the algorithm.
+		T _varwn = T(0);
+		/// Spectrum of the ACF embedded into the torus.
+		complex_array_type _spectrum;
+		/// Eigenvalues of the circulant preconditioner.
+		array_type _eigenvalues;
+		transform_type _fft_matrix;
+		transform_type _fft_preconditioner;
+
+	public:
+
+		/**
+		\param[in] acf three-dimensional auto-covariance function \f$\gamma\f$
+		\param[in] order AR model order
+		*/
+		Conjugate_gradient_solver(array_type acf, Shape3D order);
+
+		~Conjugate_gradient_solver() = default;
+
+		Conjugate_gradient_solver(const Conjugate_gradient_solver&) = delete;
+
+		Conjugate_gradient_solver&
+		operator=(const Conjugate_gradient_solver&) = delete;
+
+		/**
+		\brief Solve Yule---Walker system of equations.
+		\return three-dimensional array of coefficients with
+		\f$\varphi_{0,0,0}=0\f$
+		*/
+		array_type
+		solve();
+
+		/// \copydoc solve
+		inline array_type
+		operator()() {
+			return this->solve();
+		}
+
+		/// \copydoc _residual
+		inline value_type
+		residual() const noexcept {
+			return this->_residual;
+		}
+
+		inline void
+		residual(value_type rhs) noexcept {
+			this->_residual = rhs;
+		}
+
+		/// \copydoc _maxiterations
+		inline int
+		max_iterations() const noexcept {
+			return this->_maxiterations;
+		}
+
+		inline void
+		max_iterations(int rhs) noexcept {
+			this->_maxiterations = rhs;
+		}
+
+		/// \copydoc _niterations
+		inline int
+		num_iterations() const noexcept {
+			return this->_niterations;
+		}
+
+		/// \copydoc _varwn
+		inline value_type
+		white_noise_variance() const noexcept {
+			return this->_varwn;
+		}
+
+	private:
+
+		/// Computes \f$\Gamma x\f$.
+		array_type
+		multiply(const array_type& x);
+
+		/// Computes \f$C^{-1} r\f$.
+		array_type
+		precondition(const array_type& r);
+
+		void
+		init_spectrum();
+
+		void
+		init_preconditioner();
+
+	};
+
+}
+
+#endif // vim:filetype=cpp
@@ -5,89 +5,138 @@
 #include "types.hh"
 #include "physical_constants.hh"
 
-namespace {
-
-	template<class T>
-	struct Event {
-		Event(): x(0), y(0), period(0), elevation(0) {}
-		Event(int i, int j, T p, T z):
-		x(i), y(j), period(p), elevation(z)
-		{}
-		int x, y;
-		T period, elevation;
-	};
-
-	template<class T>
-	std::pair<T,T>
-	factor_waves_dim(blitz::Array<T, 2> z, int t, T dt) {
-		using namespace arma;
-		using namespace constants;
-		using std::abs;
-		const Shape2D& zsize = z.shape();
-		T min_k = std::numeric_limits<T>::max();
-		T max_k = std::numeric_limits<T>::min();
-		std::vector<Event<T>> events;
-		const int nx = zsize(0);
-		const int ny = zsize(1);
-		for (int y=0; y<ny; y++) {
-			for (int x=1; x<nx-1; x++) {
-				const T z0 = z(x, y);
-				const T z1 = z(x-1, y);
-				const T z2 = z(x+1, y);
-				const T dw1 = z0 - z1;
-				const T dw2 = z0 - z2;
-				if (!((dw1 > T(0))^(dw2 > T(0)))) {
-					const T a = T(-0.5)*(dw1 + dw2)/(dt*dt);
-					const T b = dw1/dt - a*dt*(T(2)*t - T(1));
-					const T c = z0 - t*dt*(a*t*dt + b);
-					const T Tex = T(-0.5)*b/a;
-					const T Wex = c + Tex*(b + a*Tex);
-					events.emplace_back(x, y, Tex, Wex);
+template<class T>
+arma::Domain<T,2>
+arma::Wave_number_estimator<T>::operator()(const Array2D<T>& z, int t, T dt) {
+	/// Rows should be contiguous, otherwise the slice is copied.
+	Array2D<T> zc(z);
+	if (z.stride(1) != 1) {
+		zc.reference(Array2D<T>(z.shape()));
+		zc = z;
+	}
+	const int nx = zc.extent(0);
+	const int ny = zc.extent(1);
+	const int stride = zc.stride(0);
+	const T* data = zc.data();
+	for (int i=0; i<2; ++i) {
+		this->_min_k[i] = std::numeric_limits<T>::max();
+		this->_max_k[i] = std::numeric_limits<T>::min();
+	}
+	this->_columns.assign(ny, Wave_chain());
+	this->_period.resize(ny);
+	this->_elevation.resize(ny);
+	this->_extremum.resize(ny);
+	for (int i=0; i<nx; ++i) {
+		const T* row = data + i*stride;
+		/// 1. Find extrema in \f$X\f$ dimension for each column.
+		if (i > 0 && i < nx-1) {
+			this->find_extrema(row - stride, row, row + stride, ny, t, dt);
+			for (int j=0; j<ny; ++j) {
+				if (this->_extremum[j]) {
+					this->push(
+						this->_columns[j],
+						this->_period[j],
+						this->_elevation[j],
+						0
+					);
 				}
 			}
 		}
-		size_t N = events.size();
-		Event<T> event1 = events[0];
-		Event<T> event2;
-		size_t j = 0;
-		for (size_t i=1; i<N; i++) {
-			if (!((event1.elevation > T(0))^(events[i].elevation > T(0)))) {
-				if (abs(event1.elevation) < abs(events[i].elevation)) {
-					event1 = events[i];
+		/// 2. Find extrema in \f$Y\f$ dimension along the row.
+		if (ny > 2) {
+			this->find_extrema(row, row + 1, row + 2, ny-2, t, dt);
+			Wave_chain chain;
+			for (int j=0; j<ny-2; ++j) {
+				if (this->_extremum[j]) {
+					this->push(chain, this->_period[j], this->_elevation[j], 1);
 				}
-			} else {
-				if (j > 0) {
-					T w = _2pi<T> / abs((event1.period - event2.period)*T(2));
-					T k = w*w/g<T>;
-					if (k < min_k) {
-						min_k = k;
-					}
-					if (k > max_k) {
-						max_k = k;
-					}
-				}
-				event2 = event1;
-				event1 = events[i];
-				j++;
 			}
 		}
-		return std::make_pair(min_k, max_k);
 	}
+	return Domain<T,2>{
+		{this->_min_k[0],this->_min_k[1]},
+		{this->_max_k[0],this->_max_k[1]},
+		{2, 2}
+	};
+}
 
+template<class T>
+void
+arma::Wave_number_estimator<T>::find_extrema(
+	const T* prev,
+	const T* cur,
+	const T* next,
+	int n,
+	int t,
+	T dt
+) {
+	T* period = this->_period.data();
+	T* elevation = this->_elevation.data();
+	unsigned char* extremum = this->_extremum.data();
+	#if ARMA_OPENMP
+	#pragma omp simd
+	#endif
+	for (int j=0; j<n; ++j) {
+		const T z0 = cur[j];
+		const T dw1 = z0 - prev[j];
+		const T dw2 = z0 - next[j];
+		const T a = T(-0.5)*(dw1 + dw2)/(dt*dt);
+		const T b = dw1/dt - a*dt*(T(2)*t - T(1));
+		const T c = z0 - t*dt*(a*t*dt + b);
+		const T Tex = T(-0.5)*b/a;
+		period[j] = Tex;
+		elevation[j] = c + Tex*(b + a*Tex);
+		extremum[j] = (dw1 > T(0)) == (dw2 > T(0));
+	}
+}
+
+template<class T>
+void
+arma::Wave_number_estimator<T>::push(
+	Wave_chain& chain,
+	T period,
+	T elevation,
+	int dim
+) {
+	using namespace constants;
+	using std::abs;
+	if (chain.size == 0) {
+		chain.period1 = period;
+		chain.elevation1 = elevation;
+		chain.size = 1;
+		return;
+	}
+	if ((chain.elevation1 > T(0)) == (elevation > T(0))) {
+		if (abs(chain.elevation1) < abs(elevation)) {
+			chain.period1 = period;
+			chain.elevation1 = elevation;
+		}
+		return;
+	}
+	if (chain.size > 1) {
+		const T w = _2pi<T> / abs((chain.period1 - chain.period2)*T(2));
+		const T k = w*w/g<T>;
+		if (k < this->_min_k[dim]) {
+			this->_min_k[dim] = k;
+		}
+		if (k > this->_max_k[dim]) {
+			this->_max_k[dim] = k;
+		}
+	}
+	chain.period2 = chain.period1;
+	chain.period1 = period;
+	chain.elevation1 = elevation;
+	chain.size = 2;
 }
 
 template<class T>
 arma::Domain<T,2>
 arma::factor_waves(Array2D<T> z, int t, T dt) {
-	std::pair<T,T> wn_range_x = factor_waves_dim(z, t, dt);
-	std::pair<T,T> wn_range_y = factor_waves_dim(z.transpose(1, 0), t, dt);
-	return Domain<T,2>{
-		{wn_range_x.first,wn_range_y.first},
-		{wn_range_x.second,wn_range_y.second},
-		{2, 2}
-	};
+	Wave_number_estimator<T> estimator;
+	return estimator(z, t, dt);
 }
 
+template class arma::Wave_number_estimator<ARMA_REAL_TYPE>;
 
 template arma::Domain<ARMA_REAL_TYPE,2>
 arma::factor_waves(
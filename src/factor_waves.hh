@@ -9,6 +9,65 @@
 
 namespace arma {
 
+	/**
+	\brief Estimates wave number range from wavy surface time slice.
+
+	Extrema are found in both dimensions in a single pass over
+	the rows of the slice. Extrema in \f$Y\f$ dimension are found
+	along the row, extrema in \f$X\f$ dimension are found by comparing
+	the row with the adjacent ones, and in both cases the values are
+	computed with a vectorised loop over contiguous memory. The state
+	of each line in \f$X\f$ dimension is kept in a buffer, which is
+	reused between the calls.
+	*/
+	template<class T>
+	class Wave_number_estimator {
+
+		/// Extrema of the line which bound the current wave.
+		struct Wave_chain {
+			T period1 = 0;
+			T elevation1 = 0;
+			T period2 = 0;
+			/// The number of extrema in the chain (at most two).
+			int size = 0;
+		};
+
+		std::vector<Wave_chain> _columns;
+		std::vector<T> _period;
+		std::vector<T> _elevation;
+		std::vector<unsigned char> _extremum;
+		/// Wave number range for \f$X\f$ and \f$Y\f$ dimensions.
+		T _min_k[2];
+		T _max_k[2];
+
+	public:
+
+		/**
+		\param[in] z  wavy surface
+		\param[in] t  time slice index
+		\param[in] dt \f$\Delta{t}\f$
+		\return wave number range
+		*/
+		Domain<T,2>
+		operator()(const Array2D<T>& z, int t, T dt);
+
+	private:
+
+		void
+		find_extrema(
+			const T* prev,
+			const T* cur,
+			const T* next,
+			int n,
+			int t,
+			T dt
+		);
+
+		void
+		push(Wave_chain& chain, T period, T elevation, int dim);
+
+	};
+
 	/**
 	   \param[in] z  wavy surface
 	   \param[in] t  time slice index
@@ -12,6 +12,10 @@ arma::operator>>(std::istream& in, AR_algorithm& rhs) {
 		rhs = AR_algorithm::Gauss_elimination;
 	} else if (name == "choi_recursive") {
 		rhs = AR_algorithm::Choi;
+	} else if (name == "levinson_whittle") {
+		rhs = AR_algorithm::Whittle;
+	} else if (name == "conjugate_gradient") {
+		rhs = AR_algorithm::Conjugate_gradient;
 	} else {
 		in.setstate(std::ios::failbit);
 		std::clog << "Invalid AR algorithm: " << name << std::endl;
@@ -25,6 +29,8 @@ arma::to_string(AR_algorithm rhs) {
 	switch (rhs) {
 		case AR_algorithm::Gauss_elimination: return "gauss_elimination";
 		case AR_algorithm::Choi: return "choi_recursive";
+		case AR_algorithm::Whittle: return "levinson_whittle";
+		case AR_algorithm::Conjugate_gradient: return "conjugate_gradient";
 		default: return "UNKNOWN";
 	}
 }
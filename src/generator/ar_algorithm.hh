@@ -14,6 +14,8 @@ namespace arma {
 	enum struct AR_algorithm {
 		Gauss_elimination = 0,
 		Choi = 1,
+		Whittle = 2,
+		Conjugate_gradient = 3,
 	};
 
 	std::istream&
@@ -1,11 +1,13 @@
 #include "ar_model.hh"
 
+#include "conjugate_gradient.hh"
 #include "linalg.hh"
 #include "params.hh"
 #include "physical_constants.hh"
 #include "util.hh"
 #include "util.hh"
 #include "voodoo.hh"
+#include "whittle.hh"
 #include "yule_walker.hh"
 
 #include <algorithm>
@@ -64,7 +66,7 @@ template <class T>
 void
 arma::generator::AR_model<T>
 ::validate() const {
-	validate_process(this->_phi);
+	validate_process_on_torus(this->_phi);
 }
 
 template <class T>
@@ -89,6 +91,12 @@ arma::generator::AR_model<T>
 	case AR_algorithm::Choi:
 		this->determine_coefficients_choi();
 		break;
+	case AR_algorithm::Whittle:
+		this->determine_coefficients_whittle();
+		break;
+	case AR_algorithm::Conjugate_gradient:
+		this->determine_coefficients_conjugate_gradient();
+		break;
 	default:
 		throw std::runtime_error("bad AR algorithm");
 	}
@@ -143,6 +151,8 @@ arma::generator::AR_model<T>
 	Yule_walker_solver<T> solver(this->_acf);
 //	solver.determine_the_order(false);
 	solver.var_epsilon(T(1e-6));
+	solver.max_residual(this->_acfresidual);
+	solver.chop(this->_chop);
 	if (all(this->_order) > 0) {
 		solver.max_order(max(this->_order));
 	}
@@ -153,6 +163,25 @@ arma::generator::AR_model<T>
 	write_key_value(std::clog, "New AR model order", this->_order);
 }
 
+template <class T>
+void
+arma::generator::AR_model<T>
+::determine_coefficients_whittle() {
+	Whittle_solver<T> solver(this->_acf, this->order());
+	this->_phi.reference(solver.solve());
+	this->_varwn = this->white_noise_variance(this->_phi);
+}
+
+template <class T>
+void
+arma::generator::AR_model<T>
+::determine_coefficients_conjugate_gradient() {
+	Conjugate_gradient_solver<T> solver(this->_acf, this->order());
+	solver.residual(this->_cgresidual);
+	this->_phi.reference(solver.solve());
+	this->_varwn = this->white_noise_variance(this->_phi);
+}
+
 template <class T>
 void
 arma::generator::AR_model<T>
@@ -167,6 +196,15 @@ arma::generator::AR_model<T>
 				"partition",
 				sys::make_param(this->_partition, validate_shape<int, 3>)
 			},
+			{
+				"cg_residual",
+				sys::make_param(this->_cgresidual, validate_positive<T>)
+			},
+			{
+				"acf_residual",
+				sys::make_param(this->_acfresidual)
+			},
+			{"chop", sys::make_param(this->_chop)},
 		},
 		true
 	};
@@ -186,6 +224,37 @@ arma::generator::AR_model<T>
 	    << ",noseed=" << this->_noseed;
 }
 
+template <class T>
+void
+arma::generator::AR_model<T>
+::write_cache_key(std::ostream& out) const {
+	Basic_ARMA_model<T>::write_cache_key(out);
+	out << ",algorithm=" << this->_algorithm;
+	if (this->_algorithm == AR_algorithm::Conjugate_gradient) {
+		out << ",cg_residual=" << this->_cgresidual;
+	}
+	if (this->_algorithm == AR_algorithm::Choi) {
+		out << ",acf_residual=" << this->_acfresidual
+		    << ",chop=" << this->_chop;
+	}
+}
+
+template <class T>
+void
+arma::generator::AR_model<T>
+::save_coefficients(std::ostream& out) const {
+	out << this->_phi;
+}
+
+template <class T>
+void
+arma::generator::AR_model<T>
+::load_coefficients(std::istream& in) {
+	if (in >> this->_phi) {
+		this->_order = this->_phi.shape();
+	}
+}
+
 #if ARMA_NONE
 #include "ar_model_sequential.cc"
 #elif ARMA_OPENCL
@@ -39,6 +39,15 @@ namespace arma {
 			Array3D<T> _phi;
 			/// The algorithm for determining the coefficients.
 			AR_algorithm _algorithm = AR_algorithm::Choi;
+			/// Maximal residual of conjugate gradient method.
+			T _cgresidual = T(1e-10);
+			/**
+			Maximal ACF residual of Choi algorithm. If positive,
+			the smallest order that reproduces the ACF is chosen.
+			*/
+			T _acfresidual = T(0);
+			/// Remove near-zero trailing coefficients in Choi algorithm.
+			bool _chop = true;
 
 		public:
 			typedef Discrete_function<T,3> acf_type;
@@ -111,6 +120,20 @@ namespace arma {
 			void
 			read(std::istream& in) override;
 
+			inline bool
+			caches_coefficients() const noexcept override {
+				return true;
+			}
+
+			void
+			write_cache_key(std::ostream& out) const override;
+
+			void
+			save_coefficients(std::ostream& out) const override;
+
+			void
+			load_coefficients(std::istream& in) override;
+
 		private:
 
 			/// Determine coefficients by simple Gauss elimintation.
@@ -121,6 +144,14 @@ namespace arma {
 			void
 			determine_coefficients_choi();
 
+			/// Multichannel Levinson recursion \cite Whittle1963.
+			void
+			determine_coefficients_whittle();
+
+			/// Preconditioned conjugate gradient method with FFT.
+			void
+			determine_coefficients_conjugate_gradient();
+
 		};
 
 		template <class T>
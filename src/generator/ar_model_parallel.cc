@@ -25,6 +25,14 @@ using namespace arma;
 
 namespace {
 
+	/**
+	The number of Mersenne Twisters and the parallelism that is used to
+	guess partition size when PRNG is not seeded. They do not depend on
+	the number of threads, so that the surface is the same for any number
+	of threads.
+	*/
+	const int noseed_parallelism = 16;
+
 	struct Partition {
 
 		Partition() = default;
@@ -84,17 +92,19 @@ arma::generator::AR_model<T>::do_generate() {
 	using blitz::RectDomain;
 	using blitz::product;
 	using std::min;
-	/// 1. Read parallel Mersenne Twister state for each thread.
+	/// 1. Read parallel Mersenne Twister state for each thread
+	/// (or a fixed number of states when PRNG is not seeded).
 	const size_t nthreads = std::max(1, omp_get_max_threads());
+	const int parallelism = this->_noseed ? noseed_parallelism : int(nthreads);
 	std::vector<prng::parallel_mt> mts =
-		prng::read_parallel_mts(MT_CONFIG_FILE, nthreads, this->_noseed);
+		prng::read_parallel_mts(MT_CONFIG_FILE, parallelism, this->_noseed);
 	/// 2. Partition the data.
 	const Shape3D shape = this->_outgrid.size();
 	const Shape3D partshape = get_partition_shape(
 		this->_partition,
 		this->grid().num_points(),
 		this->order(),
-		nthreads
+		parallelism
 	);
 	const Shape3D nparts = blitz::div_ceil(shape, partshape);
 	const int ntotal = product(nparts);
@@ -102,6 +112,10 @@ arma::generator::AR_model<T>::do_generate() {
 	std::vector<Partition> parts = partition(nparts, partshape, shape);
 	Array3D<bool> completed(nparts);
 	Array3D<T> zeta(shape);
+	/// Moments are accumulated for each partition as soon as it is
+	/// computed, and are merged in the same order at the end.
+	const RectDomain<3> vdomain = this->variance_domain(shape);
+	Array3D<stats::Moments<T>> moments(nparts);
 	std::condition_variable cv;
 	std::mutex mtx;
 	std::atomic<int> nfinished(0);
@@ -151,7 +165,7 @@ arma::generator::AR_model<T>::do_generate() {
 	#pragma omp parallel
 	{
 		const int thread_no = omp_get_thread_num();
-		prng::parallel_mt& mt = mts[thread_no];
+		prng::parallel_mt* mt = this->_noseed ? nullptr : &mts[thread_no];
 		std::unique_lock<std::mutex> lock(mtx);
 		while (!parts.empty()) {
 			typename std::vector<Partition>::iterator result;
@@ -178,12 +192,27 @@ arma::generator::AR_model<T>::do_generate() {
 			parts.erase(result);
 			lock.unlock();
 			ARMA_EVENT_START("generate_surface", "omp", thread_no);
+			/// Without seed each partition uses a copy of the generator
+			/// chosen and seeded by partition index, so that the surface
+			/// does not depend on which thread computes the partition.
+			prng::parallel_mt part_mt;
+			if (this->_noseed) {
+				const int idx = (part.ijk(0)*nparts(1) + part.ijk(1))*nparts(2)
+					+ part.ijk(2);
+				part_mt = mts[idx % mts.size()];
+				part_mt.seed(idx);
+			}
 			zeta(part.rect) = ::generate_white_noise(
 				part.shape(),
 				var_wn,
-				std::ref(mt)
+				std::ref(this->_noseed ? part_mt : *mt)
 			);
 			this->generate_surface(zeta, part.rect);
+			const Shape3D lo = blitz::max(part.rect.lbound(), vdomain.lbound());
+			const Shape3D hi = blitz::min(part.rect.ubound(), vdomain.ubound());
+			if (blitz::all(lo <= hi)) {
+				moments(part.ijk) = stats::moments(zeta(RectDomain<3>(lo, hi)));
+			}
 			ARMA_EVENT_END("generate_surface", "omp", thread_no);
 			lock.lock();
 			print_progress("generated part", ++nfinished, ntotal);
@@ -197,5 +226,8 @@ arma::generator::AR_model<T>::do_generate() {
 	if (writer.joinable()) {
 		writer.join();
 	}
+	for (const auto& m : moments) {
+		this->_moments += m;
+	}
 	return zeta;
 }
@@ -101,4 +101,32 @@ arma::generator::ARMA_model<T>
 	this->MA_model<T>::write(out);
 }
 
+template <class T>
+void
+arma::generator::ARMA_model<T>
+::write_cache_key(std::ostream& out) const {
+	out << "ar_model=";
+	this->AR_model<T>::write_cache_key(out);
+	out << ",ma_model=";
+	this->MA_model<T>::write_cache_key(out);
+}
+
+template <class T>
+void
+arma::generator::ARMA_model<T>
+::save_coefficients(std::ostream& out) const {
+	this->AR_model<T>::save_coefficients(out);
+	out << '\n' << this->MA_model<T>::_varwn << '\n';
+	this->MA_model<T>::save_coefficients(out);
+}
+
+template <class T>
+void
+arma::generator::ARMA_model<T>
+::load_coefficients(std::istream& in) {
+	this->AR_model<T>::load_coefficients(in);
+	in >> this->MA_model<T>::_varwn;
+	this->MA_model<T>::load_coefficients(in);
+}
+
 template class arma::generator::ARMA_model<ARMA_REAL_TYPE>;
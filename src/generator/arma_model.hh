@@ -59,6 +59,17 @@ namespace arma {
 				AR_model<T>::verify(zeta);
 			}
 
+			/// The surface is generated by AR model.
+			inline bool
+			writes_in_parallel() const noexcept override {
+				return AR_model<T>::writes_in_parallel();
+			}
+
+			inline bool
+			generates_in_blocks() const noexcept override {
+				return false;
+			}
+
 			#if ARMA_BSCHEDULER
 			void
 			act() override {}
@@ -92,6 +103,20 @@ namespace arma {
 			void
 			read(std::istream& in) override;
 
+			inline bool
+			caches_coefficients() const noexcept override {
+				return true;
+			}
+
+			void
+			write_cache_key(std::ostream& out) const override;
+
+			void
+			save_coefficients(std::ostream& out) const override;
+
+			void
+			load_coefficients(std::istream& in) override;
+
 		private:
 			inline static acf_type
 			slice_back(acf_type arr, Shape3D amount) {
@@ -10,7 +10,34 @@
 #include "validators.hh"
 #include "white_noise.hh"
 
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <limits>
 #include <random>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+	/// 64-bit FNV-1a hash.
+	std::uint64_t
+	fnv1a(const std::string& rhs) {
+		std::uint64_t result = UINT64_C(14695981039346656037);
+		for (unsigned char ch : rhs) {
+			result ^= ch;
+			result *= UINT64_C(1099511628211);
+		}
+		return result;
+	}
+
+}
 
 template <class T>
 sys::parameter_map::map_type
@@ -27,6 +54,7 @@ arma::generator::Basic_ARMA_model<T>::parameters() {
 		{"output", sys::make_param(this->_oflags)},
 		{"order", sys::make_param(this->_order, validate_shape<int,3>)},
 		{"validate", sys::make_param(this->_validate)},
+		{"cache", sys::make_param(this->_cachedir)},
 	};
 }
 
@@ -71,12 +99,6 @@ arma::generator::Basic_ARMA_model<T>::generate() {
 			this->grid().patch_size()
 		);
 	);
-	ARMA_PROFILE_BLOCK("nit_acf",
-		if (!this->_linear) {
-			auto copy = this->_acf.copy();
-			this->_nittransform.transform_ACF(copy);
-		}
-	);
 	arma::write_key_value(std::clog, "ACF variance", ACF_variance(this->_acf));
 	if (this->_oflags.isset(Output_flags::ACF)) {
 		if (this->_oflags.isset(Output_flags::CSV)) {
@@ -87,41 +109,190 @@ arma::generator::Basic_ARMA_model<T>::generate() {
 			out << this->_acf;
 		}
 	}
-	ARMA_PROFILE_BLOCK("determine_coefficients",
-		this->determine_coefficients();
-	);
-	ARMA_PROFILE_BLOCK("validate",
-		if (this->_validate) {
+	/// The key is computed before determining the coefficients,
+	/// because some algorithms change the order.
+	const bool use_cache =
+		!this->_cachedir.empty() && this->caches_coefficients();
+	if (!this->_cachedir.empty() && !use_cache) {
+		std::clog << "Coefficient cache is not supported by the model" << std::endl;
+	}
+	std::string cache_file;
+	bool cached = false;
+	bool validated = false;
+	if (use_cache) {
+		ARMA_PROFILE_BLOCK("load_coefficients",
+			cache_file = this->cache_filename();
+			cached = this->load_from_cache(cache_file, validated);
+		);
+	}
+	if (!cached) {
+		ARMA_PROFILE_BLOCK("determine_coefficients",
+			this->determine_coefficients();
+		);
+	}
+	const bool need_validation = this->_validate && !validated;
+	if (need_validation) {
+		ARMA_PROFILE_BLOCK("validate",
 			this->validate();
-		}
-	);
+		);
+	}
+	if (use_cache && (!cached || need_validation)) {
+		this->save_to_cache(cache_file, validated || need_validation);
+	}
 	Array3D<T> zeta;
+	this->_moments = stats::Moments<T>();
 	ARMA_PROFILE_BLOCK("generate_surface",
 		zeta.reference(this->do_generate());
 	);
+	/// The blocks are scaled and written to the file as they are generated.
+	if (this->generates_in_blocks()) {
+		return zeta;
+	}
+	if (this->_moments.count() == 0) {
+		ARMA_PROFILE_BLOCK("variance",
+			this->_moments = variance_moments(zeta);
+		);
+	}
 	// compensate for not using exponents in ACF
-	using arma::stats::variance;
-	using std::sqrt;
-	using blitz::RectDomain;
-	zeta *= sqrt(this->_acf(0,0,0) / variance(zeta(RectDomain<3>(zeta.shape()/2, zeta.shape()-1))));
+	const T scale = std::sqrt(this->_acf(0,0,0) / this->_moments.variance());
+	/// Scaling and NIT are done in the same pass over the surface.
 	ARMA_PROFILE_BLOCK("nit_realisation",
-		if (!this->_linear) {
-			this->_nittransform.transform_realisation(this->_acf, zeta);
+		if (this->_linear) {
+			zeta *= scale;
+		} else {
+			this->_nittransform.transform_realisation(this->_acf, zeta, scale);
 		}
 	);
 	return zeta;
 }
 
+template <class T>
+arma::stats::Moments<T>
+arma::generator::Basic_ARMA_model<T>
+::variance_moments(const Array3D<T>& zeta) {
+	using blitz::RectDomain;
+	const RectDomain<3> domain = variance_domain(zeta.shape());
+	const Shape3D& lo = domain.lbound();
+	const Shape3D& hi = domain.ubound();
+	/// Time slices are summed up in order to get the same result
+	/// regardless of the number of threads.
+	std::vector<stats::Moments<T>> slices(hi(0) - lo(0) + 1);
+	const int nslices = slices.size();
+	#if ARMA_OPENMP
+	#pragma omp parallel for
+	#endif
+	for (int i=0; i<nslices; ++i) {
+		const int t = lo(0) + i;
+		slices[i] = stats::moments(zeta(RectDomain<3>(
+			Shape3D(t, lo(1), lo(2)),
+			Shape3D(t, hi(1), hi(2))
+		)));
+	}
+	stats::Moments<T> result;
+	for (const auto& m : slices) {
+		result += m;
+	}
+	return result;
+}
+
+template <class T>
+void
+arma::generator::Basic_ARMA_model<T>
+::write_cache_key(std::ostream& out) const {
+	out << "sizeof(T)=" << sizeof(T)
+	    << ",order=" << this->_order
+	    << ",acf.shape=" << this->_acf.shape()
+	    << ",acf=";
+	for (const T& x : this->_acf) {
+		out.write(reinterpret_cast<const char*>(&x), sizeof(T));
+	}
+}
+
+template <class T>
+std::string
+arma::generator::Basic_ARMA_model<T>
+::cache_filename() const {
+	std::ostringstream key;
+	this->write_cache_key(key);
+	std::ostringstream filename;
+	filename << this->_cachedir << '/'
+		<< std::hex << std::setw(16) << std::setfill('0')
+		<< fnv1a(key.str());
+	return filename.str();
+}
+
+template <class T>
+bool
+arma::generator::Basic_ARMA_model<T>
+::load_from_cache(const std::string& filename, bool& validated) {
+	std::ifstream in(filename);
+	if (!in.is_open()) {
+		return false;
+	}
+	T var_wn = 0;
+	bool cached_validated = false;
+	if (!(in >> var_wn >> cached_validated)) {
+		std::cerr << "Bad coefficient cache file: " << filename << std::endl;
+		return false;
+	}
+	this->load_coefficients(in);
+	if (!in) {
+		std::cerr << "Bad coefficient cache file: " << filename << std::endl;
+		return false;
+	}
+	this->_varwn = var_wn;
+	validated = cached_validated;
+	std::clog << "Load coefficients from cache " << filename << std::endl;
+	return true;
+}
+
+template <class T>
+void
+arma::generator::Basic_ARMA_model<T>
+::save_to_cache(const std::string& filename, bool validated) const {
+	if (::mkdir(this->_cachedir.data(), 0755) == -1 && errno != EEXIST) {
+		std::cerr << "Unable to create cache directory: "
+			<< this->_cachedir << std::endl;
+		return;
+	}
+	/// Write to uniquely named temporary file in the same directory first
+	/// and then rename it, so that programmes that use the same cache
+	/// never write to the same file and never read partially written one.
+	std::vector<char> tmp_name(filename.begin(), filename.end());
+	const char suffix[] = ".XXXXXX";
+	tmp_name.insert(tmp_name.end(), suffix, suffix + sizeof(suffix));
+	const int fd = ::mkstemp(tmp_name.data());
+	if (fd == -1) {
+		std::cerr << "Unable to create temporary cache file: "
+			<< tmp_name.data() << std::endl;
+		return;
+	}
+	::fchmod(fd, 0644);
+	::close(fd);
+	const std::string tmp(tmp_name.data());
+	{
+		std::ofstream out(tmp);
+		out.precision(std::numeric_limits<T>::max_digits10);
+		out << this->_varwn << ' ' << validated << '\n';
+		this->save_coefficients(out);
+		if (!out) {
+			std::cerr << "Unable to write cache file: " << tmp << std::endl;
+			std::remove(tmp.data());
+			return;
+		}
+	}
+	if (std::rename(tmp.data(), filename.data()) != 0) {
+		std::cerr << "Unable to write cache file: " << filename << std::endl;
+		std::remove(tmp.data());
+		return;
+	}
+	std::clog << "Cache coefficients " << filename << std::endl;
+}
+
 #if ARMA_BSCHEDULER
 template <class T>
 void
 arma::generator::Basic_ARMA_model<T>::act() {
-	ARMA_PROFILE_BLOCK("nit_acf",
-		if (!this->_linear) {
-			auto copy = this->_acf.copy();
-			this->_nittransform.transform_ACF(copy);
-		}
-	);
 	arma::write_key_value(std::clog, "ACF variance", ACF_variance(this->_acf));
 	if (this->_oflags.isset(Output_flags::ACF)) {
 		if (this->_oflags.isset(Output_flags::CSV)) {
@@ -1,6 +1,9 @@
 #ifndef GENERATOR_BASIC_ARMA_MODEL_HH
 #define GENERATOR_BASIC_ARMA_MODEL_HH
 
+#include <istream>
+#include <ostream>
+#include <string>
 #include <vector>
 
 #include "acf_generator.hh"
@@ -8,6 +11,7 @@
 #include "discrete_function.hh"
 #include "nonlinear/nit_transform.hh"
 #include "params.hh"
+#include "stats/moments.hh"
 
 namespace arma {
 
@@ -34,13 +38,64 @@ namespace arma {
 			bool _linear = true;
 			/// Perform AR/MA process validation or not.
 			bool _validate = true;
+			/**
+			The directory where the coefficients and white noise variance
+			are cached between runs. Caching is disabled when it is empty.
+			*/
+			std::string _cachedir;
+			/**
+			Moments of the realisation in \link variance_domain\endlink.
+			Models that generate the surface in parts accumulate them
+			as the parts are finished, otherwise they are computed
+			after the generation.
+			*/
+			stats::Moments<T> _moments;
 
 			virtual Array3D<T>
 			do_generate() = 0;
 
+			/**
+			The part of the realisation that is used to estimate
+			its variance. The first half is omitted in each dimension
+			to exclude the transient at the beginning of the process.
+			*/
+			static inline blitz::RectDomain<3>
+			variance_domain(const Shape3D& shape) {
+				return blitz::RectDomain<3>(shape/2, shape-1);
+			}
+
+			/// Computes moments of the realisation in \link variance_domain\endlink.
+			static stats::Moments<T>
+			variance_moments(const Array3D<T>& zeta);
+
 			Array3D<T>
 			generate_white_noise();
 
+			/**
+			Write everything the coefficients depend on: the order,
+			the ACF and the parameters of the algorithm. The cache file
+			name is the hash of the output.
+			*/
+			virtual void
+			write_cache_key(std::ostream& out) const;
+
+			/**
+			Whether the model supports coefficient cache. Models that
+			do not support it ignore "cache" parameter.
+			*/
+			virtual bool
+			caches_coefficients() const noexcept {
+				return false;
+			}
+
+			/// Write coefficients to the cache file.
+			virtual void
+			save_coefficients(std::ostream& out) const {}
+
+			/// Read coefficients from the cache file.
+			virtual void
+			load_coefficients(std::istream& in) {}
+
 		public:
 			inline
 			Basic_ARMA_model() = default;
@@ -108,6 +163,23 @@ namespace arma {
 			Array3D<T>
 			generate() override;
 
+		private:
+			std::string
+			cache_filename() const;
+
+			/**
+			\brief Load coefficients from the cache.
+			\param[in] filename cache file name
+			\param[out] validated whether the cached process has already
+			been validated
+			\return true on cache hit
+			*/
+			bool
+			load_from_cache(const std::string& filename, bool& validated);
+
+			void
+			save_to_cache(const std::string& filename, bool validated) const;
+
 		};
 
 	}
@@ -1,11 +1,21 @@
 #include <algorithm>
+#include <exception>
 #include <fstream>
+#include <functional>
 #include <iterator>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <vector>
+#if ARMA_OPENMP
+#include <omp.h>
+#endif
 
 #include "grid.hh"
+#include "profile.hh"
 #include "stats/distribution.hh"
+#include "stats/moments.hh"
+#include "stats/quantile_sketch.hh"
 #include "stats/statistics.hh"
 #include "stats/summary.hh"
 #include "stats/waves.hh"
@@ -16,13 +26,14 @@ namespace {
 	template <class T>
 	void
 	print_indicator(
+		std::ostream& out,
 		std::string prefix,
 		std::string name,
 		T expected,
 		T actual,
 		bool ok
 	) {
-		std::clog
+		out
 			<< std::left
 			<< std::setw(15) << prefix
 			<< std::setw(20) << name
@@ -33,6 +44,85 @@ namespace {
 			<< std::endl;
 	}
 
+	/**
+	Runs independent stages concurrently as OpenMP tasks. The threads
+	are divided between the stages, so that parallel loops inside each
+	stage use their share of the threads. The first exception thrown
+	by the stages is rethrown when all of them are finished.
+	*/
+	void
+	run_stages(const std::vector<std::function<void()>>& stages) {
+		const int nstages = stages.size();
+		std::vector<std::exception_ptr> errors(nstages);
+		#if ARMA_OPENMP
+		const int nthreads = std::max(1, omp_get_max_threads());
+		const int threads_per_stage = std::max(1, nthreads / std::max(1, nstages));
+		const int old_levels = omp_get_max_active_levels();
+		omp_set_max_active_levels(std::max(old_levels, 2));
+		#pragma omp parallel num_threads(std::max(1, std::min(nstages, nthreads)))
+		#pragma omp single
+		for (int i=0; i<nstages; ++i) {
+			#pragma omp task firstprivate(i)
+			{
+				omp_set_num_threads(threads_per_stage);
+				try {
+					stages[i]();
+				} catch (...) {
+					errors[i] = std::current_exception();
+				}
+			}
+		}
+		omp_set_max_active_levels(old_levels);
+		#else
+		for (int i=0; i<nstages; ++i) {
+			try {
+				stages[i]();
+			} catch (...) {
+				errors[i] = std::current_exception();
+			}
+		}
+		#endif
+		for (const auto& error : errors) {
+			if (error) {
+				std::rethrow_exception(error);
+			}
+		}
+	}
+
+	/**
+	Computes moments and quantile sketch of the surface in one pass.
+	Time slices are processed in parallel, and their statistics are
+	merged in order to get the same result regardless of the number
+	of threads.
+	*/
+	template <class T>
+	void
+	surface_statistics(
+		arma::Array3D<T> zeta,
+		arma::stats::Moments<T>& moments,
+		arma::stats::Quantile_sketch<T>& sketch
+	) {
+		using blitz::Range;
+		const int nt = zeta.extent(0);
+		std::vector<arma::stats::Moments<T>> slice_moments(nt);
+		std::vector<arma::stats::Quantile_sketch<T>> slice_sketches(nt);
+		#if ARMA_OPENMP
+		#pragma omp parallel for
+		#endif
+		for (int i=0; i<nt; ++i) {
+			arma::stats::Moments<T>& m = slice_moments[i];
+			arma::stats::Quantile_sketch<T>& s = slice_sketches[i];
+			for (const T& x : arma::Array2D<T>(zeta(i, Range::all(), Range::all()))) {
+				m.push(x);
+				s.push(x);
+			}
+		}
+		for (int i=0; i<nt; ++i) {
+			moments += slice_moments[i];
+			sketch += slice_sketches[i];
+		}
+	}
+
 	template <class T>
 	void
 	show_statistics(
@@ -45,21 +135,45 @@ namespace {
 		using stats::Summary;
 		using stats::Wave_field;
 		const T var_wn = model.white_noise_variance();
-		Array3D<T> spectrum =
-			arma::stats::frequency_amplitude_spectrum(zeta, model.grid());
-		{
-			std::ofstream out("spectrum");
-			out << spectrum;
-		}
 		T var_elev = acf(0,0,0);
 		const T r = 9;
-		Wave_field<T> wave_field(zeta, model.grid(), r);
-		Array1D<T> heights_x = wave_field.heights_x();
-		Array1D<T> heights_y = wave_field.heights_y();
-		Array1D<T> periods = wave_field.periods();
-		Array1D<T> lengths_x = wave_field.lengths_x();
-		Array1D<T> lengths_y = wave_field.lengths_y();
-		const T est_var_elev = stats::variance(zeta);
+		/// 1. Estimate the spectrum, the statistics of elevation and
+		/// extract the waves concurrently. The spectrum is written
+		/// while the other stages are running.
+		Array3D<T> spectrum;
+		stats::Moments<T> elev_moments;
+		stats::Quantile_sketch<T> elev_sketch;
+		std::unique_ptr<Wave_field<T>> wave_field;
+		run_stages({
+			[&] () {
+				ARMA_PROFILE_BLOCK("verify_spectrum",
+					spectrum.reference(
+						stats::frequency_amplitude_spectrum(zeta, model.grid())
+					);
+				);
+				ARMA_PROFILE_BLOCK("write_spectrum",
+					std::ofstream out("spectrum");
+					out << spectrum;
+				);
+			},
+			[&] () {
+				ARMA_PROFILE_BLOCK("verify_elevation",
+					surface_statistics(zeta, elev_moments, elev_sketch);
+				);
+			},
+			[&] () {
+				ARMA_PROFILE_BLOCK("verify_waves",
+					wave_field.reset(new Wave_field<T>(zeta, model.grid(), r));
+				);
+			}
+		});
+		/// 2. Fit the distributions and compute the summaries.
+		Array1D<T> heights_x = wave_field->heights_x();
+		Array1D<T> heights_y = wave_field->heights_y();
+		Array1D<T> periods = wave_field->periods();
+		Array1D<T> lengths_x = wave_field->lengths_x();
+		Array1D<T> lengths_y = wave_field->lengths_y();
+		const T est_var_elev = elev_moments.variance();
 		stats::Gaussian<T> eps_dist(0, std::sqrt(var_wn));
 		stats::Gaussian<T> elev_dist(0, std::sqrt(est_var_elev));
 		stats::Wave_periods_dist<T> periods_dist(stats::mean(periods));
@@ -69,7 +183,8 @@ namespace {
 		stats::Wave_lengths_dist<T> lengths_y_dist(stats::mean(lengths_y));
 		std::vector<Summary<T>> stats = {
 			make_summary(
-				zeta,
+				elev_moments,
+				elev_sketch,
 				T(0),
 				var_elev,
 				elev_dist,
@@ -183,71 +298,85 @@ namespace {
 				<< std::endl;
 		}
 		*/
+		/// 3. Write the reports concurrently.
+		std::vector<std::function<void()>> reports;
 		if (oflags.isset(Output_flags::Quantile)) {
-			std::for_each(
-				stats.begin(),
-				stats.end(),
-				std::mem_fn(&Summary<T>::write_quantile_graph)
-			);
+			for (Summary<T>& s : stats) {
+				reports.emplace_back([&s] () {
+					ARMA_PROFILE_BLOCK("write_quantile_graph",
+						s.write_quantile_graph();
+					);
+				});
+			}
 		}
 		if (oflags.isset(Output_flags::Summary)) {
-			std::clog << "No. of waves = "
-				<< Shape3D(periods.size(), lengths_x.size(), lengths_y.size())
-				<< std::endl;
-			auto oldf = std::clog.flags();
-			std::clog.setf(std::ios::fixed, std::ios::floatfield);
-			std::clog.setf(std::ios::boolalpha);
-			std::clog.precision(3);
-			for (const Summary<T>& s : stats) {
-				print_indicator(
-					"mean",
-					s.name(),
-					s.expected_mean(),
-					s.mean(),
-					s.mean_ok()
-				);
-				if (s.has_variance()) {
+			reports.emplace_back([&] () {
+				/// The report is written at once, because the other stages
+				/// write profile output to the same stream.
+				std::ostringstream out;
+				out << "No. of waves = "
+					<< Shape3D(periods.size(), lengths_x.size(), lengths_y.size())
+					<< std::endl;
+				out.setf(std::ios::fixed, std::ios::floatfield);
+				out.setf(std::ios::boolalpha);
+				out.precision(3);
+				for (const Summary<T>& s : stats) {
 					print_indicator(
-						"variance",
+						out,
+						"mean",
 						s.name(),
-						s.expected_variance(),
-						s.variance(),
-						s.variance_ok()
+						s.expected_mean(),
+						s.mean(),
+						s.mean_ok()
+					);
+					if (s.has_variance()) {
+						print_indicator(
+							out,
+							"variance",
+							s.name(),
+							s.expected_variance(),
+							s.variance(),
+							s.variance_ok()
+						);
+					}
+				}
+				for (const Summary<T>& s : stats) {
+					print_indicator(
+						out,
+						"qdistance",
+						s.name(),
+						T(0),
+						s.qdistance(),
+						s.qdistance_ok()
 					);
 				}
-			}
-			for (const Summary<T>& s : stats) {
-				print_indicator(
-					"qdistance",
-					s.name(),
-					T(0),
-					s.qdistance(),
-					s.qdistance_ok()
-				);
-			}
 
-			if (model.acf_generator().has_x()) {
-				const T r = stats::mean(lengths_x) / stats::mean(heights_x);
-				print_indicator(
-					"ratio",
-					"height to length x",
-					T(7),
-					r,
-					r > T(7) && r < T(40)
-				);
-			}
-			if (model.acf_generator().has_y()) {
-				const T r = stats::mean(lengths_y) / stats::mean(heights_y);
-				print_indicator(
-					"ratio",
-					"height to length y",
-					T(7),
-					r,
-					r > T(7) && r < T(40)
-				);
-			}
-			std::clog.setf(oldf);
+				if (model.acf_generator().has_x()) {
+					const T r = stats::mean(lengths_x) / stats::mean(heights_x);
+					print_indicator(
+						out,
+						"ratio",
+						"height to length x",
+						T(7),
+						r,
+						r > T(7) && r < T(40)
+					);
+				}
+				if (model.acf_generator().has_y()) {
+					const T r = stats::mean(lengths_y) / stats::mean(heights_y);
+					print_indicator(
+						out,
+						"ratio",
+						"height to length y",
+						T(7),
+						r,
+						r > T(7) && r < T(40)
+					);
+				}
+				std::clog << out.str() << std::flush;
+			});
 		}
+		run_stages(reports);
 	}
 
 	template<class T, int N>
@@ -315,6 +444,8 @@ arma::generator::Basic_ARMA_model<T>::verify(Array3D<T> zeta) const {
 		);
 	}
 	if (this->_oflags.isset(Output_flags::Waves)) {
-		write_everything_to_files(this->_acf, zeta, this->_outgrid);
+		ARMA_PROFILE_BLOCK("write_waves",
+			write_everything_to_files(this->_acf, zeta, this->_outgrid);
+		);
 	}
 }
@@ -42,7 +42,9 @@ namespace arma {
 			grid_type _outgrid;
 			Output_flags _oflags;
 			/// Whether seed PRNG or not. This flag is needed for
-			/// reproducible tests.
+			/// reproducible tests. In AR model it also makes partition
+			/// size and PRNG selection independent of the number
+			/// of threads.
 			bool _noseed = false;
 			#if ARMA_BSCHEDULER
 			Array3D<T> _zeta;
@@ -102,6 +104,17 @@ namespace arma {
 				return false;
 			}
 
+			/**
+			Whether the surface is generated and written to the file block
+			by block, so that only the last block is returned by
+			\link generate\endlink. The returned block is neither verified
+			nor used to compute velocity potentials.
+			*/
+			virtual bool
+			generates_in_blocks() const noexcept {
+				return false;
+			}
+
 			virtual void
 			validate() const {}
 			virtual Array3D<T>
@@ -224,6 +224,7 @@ arma::generator::Longuet_Higgins_model<T>::read(std::istream& in) {
 		{"wave_height", sys::make_param(this->_waveheight)},
 		{"out_grid", sys::make_param(this->_outgrid, validate_grid<T,3>)},
 		{"output", sys::make_param(this->_oflags)},
+		{"no_seed", sys::make_param(this->_noseed)},
 	}, true);
 	in >> params;
 	validate_domain<T,2>(this->_spec_domain, "lh_model.spec_domain");
@@ -237,7 +238,8 @@ arma::generator::Longuet_Higgins_model<T>::write(std::ostream& out) const {
 	out << "grid=" << this->grid()
 		<< ",spec_domain=" << this->_spec_domain
 		<< ",spec_subdomain=" << this->_spec_subdomain
-		<< ",wave_height=" << this->_waveheight;
+		<< ",wave_height=" << this->_waveheight
+		<< ",noseed=" << this->_noseed;
 }
 
 template class arma::generator::Longuet_Higgins_model<ARMA_REAL_TYPE>;
@@ -1,16 +1,95 @@
 #include "ma_coefficient_solver.hh"
 
 #include <algorithm>
-#include <fstream>
+#include <cmath>
+#include <complex>
 #include <iostream>
-#include <limits>
 #include <random>
 #include <stdexcept>
 
 #include "blitz.hh"
+#include "fourier.hh"
+#include "linalg.hh"
 #include "params.hh"
 #include "validators.hh"
 
+namespace {
+
+	/**
+	\brief Computes auto-correlation \f$r_d=\sum_p c_{p+d}c_p\f$
+	of the coefficients for non-negative lags \f$d\f$.
+
+	The coefficients are padded with noughts to twice their size
+	to eliminate circular wrap-around, and the auto-correlation is
+	computed as \f$\mathcal{F}^{-1}\left\{|\mathcal{F}\{c\}|^2\right\}\f$.
+	Fourier transform and the buffer are allocated once and reused
+	on every iteration.
+	*/
+	template <class T>
+	class Auto_correlation {
+
+		typedef std::complex<T> C;
+
+		arma::Shape3D _shape;
+		arma::apmath::Fourier_transform<C,3> _fft;
+		arma::Array3D<C> _buffer;
+
+	public:
+
+		inline explicit
+		Auto_correlation(const arma::Shape3D& shape):
+		_shape(shape),
+		_fft(arma::Shape3D(2*shape)),
+		_buffer(arma::Shape3D(2*shape))
+		{}
+
+		void
+		operator()(const arma::Array3D<T>& c, arma::Array3D<T>& result) {
+			using blitz::abs;
+			using blitz::pow2;
+			using blitz::real;
+			const blitz::RectDomain<3> domain(arma::Shape3D(0,0,0), this->_shape-1);
+			this->_buffer = C(0);
+			this->_buffer(domain) = c;
+			this->_fft.forward(this->_buffer);
+			this->_buffer = pow2(abs(this->_buffer));
+			this->_fft.backward(this->_buffer);
+			result = real(this->_buffer(domain)) / T(this->_buffer.numElements());
+		}
+
+	};
+
+	/**
+	\brief Computes \f$\sum_p \theta_{p+d}\theta_p\f$ for lag
+	\f$d=(i,j,k)\f$ without temporary arrays.
+
+	The innermost sum is over contiguous memory and is vectorised.
+	*/
+	template <class T>
+	inline T
+	lagged_product(const arma::Array3D<T>& theta, int i, int j, int k) {
+		const int ni = theta.extent(0);
+		const int nj = theta.extent(1);
+		const int nk = theta.extent(2);
+		const int n = nk - k;
+		T sum = 0;
+		for (int l=0; l<ni-i; ++l) {
+			for (int m=0; m<nj-j; ++m) {
+				const T* lhs = &theta(l+i,m+j,k);
+				const T* rhs = &theta(l,m,0);
+				#if ARMA_OPENMP
+				#pragma omp simd reduction(+:sum)
+				#endif
+				for (int s=0; s<n; ++s) {
+					sum += lhs[s]*rhs[s];
+				}
+			}
+		}
+		return sum;
+	}
+
+}
+
 template <class T>
 arma::generator::MA_coefficient_solver<T>
 ::MA_coefficient_solver(Array3D<T> acf, const Shape3D& order):
@@ -26,7 +105,28 @@ template <class T>
 arma::Array3D<T>
 arma::generator::MA_coefficient_solver<T>
 ::solve() {
-	return this->solve_fixed_point_iteration();
+	switch (this->_algorithm) {
+	case MA_algorithm::Fixed_point_iteration:
+		return this->solve_fixed_point_iteration();
+	case MA_algorithm::Newton_Raphson:
+		return this->solve_newton_raphson();
+	default:
+		throw std::runtime_error("bad MA algorithm");
+	}
+}
+
+template <class T>
+void
+arma::generator::MA_coefficient_solver<T>
+::write_trace(const Array3D<T>& theta) {
+	if (this->_trace) {
+		std::ostream& out = *this->_trace;
+		for (T t : theta) {
+			out << t << '\n';
+		}
+		out << "\n\n";
+		out << std::flush;
+	}
 }
 
 template <class T>
@@ -38,7 +138,6 @@ arma::generator::MA_coefficient_solver<T>
 	using blitz::all;
 	using blitz::isfinite;
 	using blitz::max;
-	using blitz::sum;
 	using std::abs;
 	const int max_iterations = this->_maxiterations;
 	const T min_var_wn = this->_minvarwn;
@@ -50,12 +149,15 @@ arma::generator::MA_coefficient_solver<T>
 	const int ni = order(0);
 	const int nj = order(1);
 	const int nk = order(2);
+	Array3D<T> acf(order);
+	acf = this->_acf(RectDomain<3>(Shape3D(0,0,0), order-1));
+	Array3D<T> r(order);
+	Auto_correlation<T> auto_correlation(order);
 	/// 1. Precompute white noise variance for the first iteration.
 	T var_wn = this->_acf(0,0,0);
 	T old_var_wn = 0;
 	T residual = 0;
 	int it = 0;
-	std::ofstream out("theta_all");
 	do {
 		/**
 		   2. Update coefficients from back to front using the
@@ -74,21 +176,14 @@ arma::generator::MA_coefficient_solver<T>
 		for (int i = ni - 1; i >= 0; --i) {
 			for (int j = nj - 1; j >= 0; --j) {
 				for (int k = nk - 1; k >= 0; --k) {
-					const Shape3D ijk(i,j,k);
-					RectDomain<3> sub1(ijk, order - 1);
-					RectDomain<3> sub2(Shape3D(0,0,0), order - ijk - 1);
 					theta(i,j,k) =
-						-this->_acf(i,j,k) / var_wn +
-						sum(theta(sub1)*theta(sub2));
+						-acf(i,j,k) / var_wn +
+						lagged_product(theta, i, j, k);
 				}
 			}
 		}
 		theta(0,0,0) = -1;
-		for (T t : theta) {
-			out << t << '\n';
-		}
-		out << "\n\n";
-		out << std::flush;
+		this->write_trace(theta);
 		/// 3. Ensure that coefficients are finite.
 		if (!all(isfinite(theta))) {
 			std::cerr << __func__
@@ -96,24 +191,14 @@ arma::generator::MA_coefficient_solver<T>
 			          << std::endl;
 			throw std::runtime_error("bad MA model coefficients");
 		}
-		/// 4. Calculate residual. Here \f$\theta_{0,0,0} \equiv -1\f$.
+		/**
+		4. Calculate residual \f$\max|\gamma_d-\sigma_\alpha^2 r_d|\f$,
+		where \f$r\f$ is auto-correlation of the coefficients.
+		Here \f$\theta_{0,0,0} \equiv -1\f$.
+		*/
 		theta(0,0,0) = -1;
-		residual = std::numeric_limits<T>::min();
-		for (int i=0; i<ni; ++i) {
-			for (int j=0; j<nj; ++j) {
-				for (int k=0; k<nk; ++k) {
-					const Shape3D ijk(i,j,k);
-					RectDomain<3> sub1(ijk, order-1);
-					RectDomain<3> sub2(Shape3D(0,0,0), order-ijk-1);
-					T new_residual = abs(
-						this->_acf(i,j,k) - sum(theta(sub1)*theta(sub2))*var_wn
-					                 );
-					if (residual < new_residual) {
-						residual = new_residual;
-					}
-				}
-			}
-		}
+		auto_correlation(theta, r);
+		residual = max(abs(acf - r*var_wn));
 		/// 5. Compute white noise variance by calling
 		/// \link MA_coefficient_solver::white_noise_variance \endlink.
 		old_var_wn = var_wn;
@@ -146,6 +231,113 @@ arma::generator::MA_coefficient_solver<T>
 	return theta;
 }
 
+template <class T>
+arma::Array3D<T>
+arma::generator::MA_coefficient_solver<T>
+::solve_newton_raphson() {
+	using blitz::RectDomain;
+	using blitz::abs;
+	using blitz::all;
+	using blitz::isfinite;
+	using blitz::max;
+	const int max_iterations = this->_maxiterations;
+	const T min_var_wn = this->_minvarwn;
+	const T max_residual = this->_maxresidual;
+	const Shape3D order = this->_order;
+	const int ni = order(0);
+	const int nj = order(1);
+	const int nk = order(2);
+	const int n = blitz::product(order);
+	Array3D<T> acf(order);
+	acf = this->_acf(RectDomain<3>(Shape3D(0,0,0), order-1));
+	/// 1. Start with white noise: \f$c_0=\sqrt{\gamma_0}\f$.
+	Array3D<T> c(order);
+	c = 0;
+	c(0,0,0) = std::sqrt(acf(0,0,0));
+	Array3D<T> r(order);
+	Auto_correlation<T> auto_correlation(order);
+	linalg::Matrix<T> J(n, n);
+	linalg::Vector<T> rhs(n);
+	T residual = 0;
+	int it = 0;
+	while (true) {
+		/// 2. Calculate residual \f$\max|r_d-\gamma_d|\f$.
+		auto_correlation(c, r);
+		residual = max(abs(r - acf));
+		std::clog << __func__ << ':' << "Iteration=" << it
+		          << ",var_wn=" << c(0,0,0)*c(0,0,0)
+		          << ",resudual=" << residual
+		          << std::endl;
+		if (!(residual > max_residual) || it >= max_iterations) {
+			break;
+		}
+		/**
+		3. Compute the Jacobian
+		\f$J_{d,q} = c_{q-d} + c_{q+d}\f$, where coefficients with
+		indices outside of the order are noughts.
+		*/
+		#if ARMA_OPENMP
+		#pragma omp parallel for collapse(3)
+		#endif
+		for (int i=0; i<ni; ++i) {
+			for (int j=0; j<nj; ++j) {
+				for (int k=0; k<nk; ++k) {
+					T* row = &J((i*nj + j)*nk + k, 0);
+					for (int l=0; l<ni; ++l) {
+						for (int m=0; m<nj; ++m) {
+							for (int s=0; s<nk; ++s) {
+								T v = 0;
+								if (l >= i && m >= j && s >= k) {
+									v += c(l-i, m-j, s-k);
+								}
+								if (l+i < ni && m+j < nj && s+k < nk) {
+									v += c(l+i, m+j, s+k);
+								}
+								*row++ = v;
+							}
+						}
+					}
+				}
+			}
+		}
+		/// 4. Solve \f$J(c)\,c' = r(c) + \gamma\f$.
+		for (int a=0; a<n; ++a) {
+			rhs(a) = r.data()[a] + acf.data()[a];
+		}
+		linalg::LU_factorisation<T>(J).solve(rhs);
+		std::copy_n(rhs.data(), n, c.data());
+		/// 5. Ensure that coefficients are finite.
+		if (!all(isfinite(c))) {
+			std::cerr << __func__
+			          << ": bad coefficients"
+			          << std::endl;
+			throw std::runtime_error("bad MA model coefficients");
+		}
+		if (this->_trace) {
+			this->write_trace(Array3D<T>(-c / c(0,0,0)));
+		}
+		++it;
+	}
+	/// 6. Validate white noise variance \f$\sigma_\alpha^2=c_0^2\f$.
+	const T c0 = c(0,0,0);
+	const T var_wn = c0*c0;
+	if (var_wn <= min_var_wn) {
+		std::cerr << __func__
+		          << ": bad white noise variance = " << var_wn
+		          << std::endl;
+		throw std::runtime_error("bad white noise variance");
+	}
+	Array3D<T> theta(order);
+	theta = -c / c0;
+	std::clog << "Calculated MA model coefficients:"
+	          << "\n\tno. of iterations = " << it
+	          << "\n\twhite noise variance = " << var_wn
+	          << "\n\tmax(theta) = " << max(abs(theta))
+	          << "\n\tmax(residual) = " << residual
+	          << std::endl;
+	return theta;
+}
+
 template <class T>
 std::istream&
 arma::generator::operator>>(std::istream& in, MA_coefficient_solver<T>& rhs) {
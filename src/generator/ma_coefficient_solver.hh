@@ -1,7 +1,10 @@
 #ifndef GENERATOR_MA_COEFFICIENT_SOLVER_HH
 #define GENERATOR_MA_COEFFICIENT_SOLVER_HH
 
+#include <ostream>
+
 #include "arma.hh"
+#include "ma_algorithm.hh"
 
 namespace arma {
 
@@ -14,7 +17,8 @@ namespace arma {
 		   \date 2018-01-24
 		   \author Ivan Gankevich
 
-		   The solver uses fixed point iteration to find the coefficients.
+		   The solver uses either fixed point iteration or Newton---Raphson
+		   method \cite Wilson1969 to find the coefficients.
 		 */
 		template <class T>
 		class MA_coefficient_solver {
@@ -36,6 +40,10 @@ namespace arma {
 			T _minvarwn = T(1e-6);
 			/// Minimal white noise variance difference between iterations.
 			T _epsvarwn = T(1e-5);
+			/// The algorithm that determines the coefficients.
+			MA_algorithm _algorithm = MA_algorithm::Fixed_point_iteration;
+			/// Optional stream to which the coefficients are written on every iteration.
+			std::ostream* _trace = nullptr;
 
 		public:
 
@@ -109,6 +117,22 @@ namespace arma {
 				return this->_epsvarwn;
 			}
 
+			inline MA_algorithm
+			algorithm() const noexcept {
+				return this->_algorithm;
+			}
+
+			inline void
+			algorithm(MA_algorithm rhs) noexcept {
+				this->_algorithm = rhs;
+			}
+
+			/// Write the coefficients to \p out on every iteration.
+			inline void
+			trace(std::ostream& out) noexcept {
+				this->_trace = &out;
+			}
+
 			inline T
 			white_noise_variance(const Array3D<T>& theta) const {
 				return MA_white_noise_variance(this->_acf, theta);
@@ -123,6 +147,20 @@ namespace arma {
 			Array3D<T>
 			solve_fixed_point_iteration();
 
+			/**
+			Solves \f$\sum_p c_{p+d}c_p=\gamma_d\f$ for
+			\f$c=\sigma_\alpha\left(1,-\theta\right)\f$ with Newton---Raphson
+			method. Each iteration solves linear system
+			\f$J(c)\,c' = r(c) + \gamma\f$, where \f$J\f$ is the Jacobian
+			and \f$r\f$ is the auto-correlation of the current coefficients
+			computed with FFT. The method converges quadratically.
+			*/
+			Array3D<T>
+			solve_newton_raphson();
+
+			void
+			write_trace(const Array3D<T>& theta);
+
 		};
 
 		template <class T>
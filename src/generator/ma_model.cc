@@ -1,17 +1,26 @@
 #include "ma_model.hh"
 
 #include "apmath/convolution.hh"
+#include "apmath/direct_convolution.hh"
+#include "io/binary_stream.hh"
 #include "linalg.hh"
 #include "ma_coefficient_solver.hh"
 #include "params.hh"
+#include "parallel_mt.hh"
 #include "profile.hh"
+#include "util.hh"
 #include "validators.hh"
 #include "voodoo.hh"
+#include "white_noise.hh"
 
 #include <algorithm>
 #include <cassert>
 #include <complex>
+#include <iostream>
+#include <memory>
 #include <random>
+#include <stdexcept>
+#include <vector>
 
 template <class T>
 T
@@ -24,13 +33,16 @@ template <class T>
 void
 arma::generator::MA_model<T>
 ::validate() const {
-	validate_process(this->_theta);
+	validate_process_on_torus(this->_theta);
 }
 
 template <class T>
 arma::Array3D<T>
 arma::generator::MA_model<T>
 ::do_generate() {
+	if (this->_timeblock > 0) {
+		return this->generate_streaming();
+	}
 	ARMA_PROFILE_START(generate_white_noise);
 	Array3D<T> eps = this->generate_white_noise();
 	ARMA_PROFILE_END(generate_white_noise);
@@ -39,6 +51,16 @@ arma::generator::MA_model<T>
 	return zeta;
 }
 
+template <class T>
+arma::Array3D<T>
+arma::generator::MA_model<T>
+::convolution_kernel() const {
+	Array3D<T> theta(this->_theta.shape());
+	theta = -this->_theta;
+	theta(0,0,0) = 1;
+	return theta;
+}
+
 template <class T>
 void
 arma::generator::MA_model<T>
@@ -50,16 +72,144 @@ arma::generator::MA_model<T>
 	using blitz::real;
 	typedef std::complex<T> C;
 	typedef apmath::Convolution<C,3> convolution_type;
+	/// Use direct convolution for small and degenerate kernels
+	/// when it is cheaper than the convolution based on FFT.
+	Array3D<T> theta = this->convolution_kernel();
+	apmath::Direct_convolution<T> direct(theta);
+	const double direct_cost = direct.cost(eps.shape());
+	const double fft_cost = convolution_type::cost(eps.shape(), theta.shape());
+	if (direct_cost < fft_cost) {
+		write_key_value(
+			std::clog,
+			"MA convolution",
+			direct.separable() ? "direct separable" : "direct"
+		);
+		direct.convolve(eps, zeta);
+		return;
+	}
+	write_key_value(std::clog, "MA convolution", "fft");
 	Array3D<C> signal(eps.shape());
 	signal = eps;
-	Array3D<C> kernel(this->_theta.shape());
-	kernel = this->_theta;
-	kernel(0,0,0) = -1;
-	kernel = -kernel;
+	Array3D<C> kernel(theta.shape());
+	kernel = theta;
 	convolution_type conv(signal, kernel);
 	zeta = real(conv.convolve(signal, kernel));
 }
 
+template <class T>
+arma::Array3D<T>
+arma::generator::MA_model<T>
+::generate_streaming() {
+	using blitz::Range;
+	using blitz::RectDomain;
+	using blitz::pow2;
+	using blitz::real;
+	using blitz::sum;
+	using blitz::toEnd;
+	typedef std::complex<T> C;
+	typedef apmath::Convolution<C,3> convolution_type;
+	const T var_wn = this->white_noise_variance();
+	write_key_value(std::clog, "White noise variance", var_wn);
+	if (var_wn < T(0)) {
+		throw std::invalid_argument("variance is less than zero");
+	}
+	const Shape3D shape = this->grid().num_points();
+	const int nt = shape(0);
+	const int block = std::min(this->_timeblock, nt);
+	const int history = this->_theta.extent(0) - 1;
+	const Shape3D buffer_shape(history + block, shape(1), shape(2));
+	write_key_value(std::clog, "MA time block", block);
+	/// 1. Choose convolution method once for all blocks.
+	Array3D<T> theta = this->convolution_kernel();
+	apmath::Direct_convolution<T> direct(theta);
+	const bool use_direct = direct.cost(buffer_shape) <
+		convolution_type::cost(buffer_shape, theta.shape());
+	write_key_value(
+		std::clog,
+		"MA convolution",
+		use_direct
+		? (direct.separable() ? "direct separable" : "direct")
+		: "fft"
+	);
+	Array3D<C> kernel;
+	Array3D<C> signal;
+	std::unique_ptr<convolution_type> conv;
+	if (!use_direct) {
+		kernel.resize(theta.shape());
+		kernel = theta;
+		signal.resize(buffer_shape);
+		conv.reset(new convolution_type(signal, kernel));
+	}
+	/// 2. The blocks are written before the whole surface is known, hence
+	/// the scale is computed from the variance of the process instead of
+	/// the variance of the realisation.
+	const T scale = std::sqrt(this->_acf(0,0,0) / (var_wn*sum(pow2(theta))));
+	write_key_value(std::clog, "MA scale", scale);
+	const RectDomain<3> vdomain = this->variance_domain(shape);
+	const Shape3D& lo = vdomain.lbound();
+	const Shape3D& hi = vdomain.ubound();
+	std::vector<stats::Moments<T>> slice_moments(block);
+	/// 3. Generate white noise and the surface block by block.
+	std::vector<prng::parallel_mt> mts = prng::read_parallel_mts(this->_noseed);
+	std::normal_distribution<T> dist(T(0), std::sqrt(var_wn));
+	Array3D<T> eps(buffer_shape);
+	eps = 0;
+	Array3D<T> eps_block(eps, Range(history, toEnd), Range::all(), Range::all());
+	Array3D<T> zeta(buffer_shape);
+	Array3D<T> zeta_block(zeta, Range(history, toEnd), Range::all(), Range::all());
+	std::unique_ptr<io::Binary_stream> out;
+	if (this->writes_in_parallel()) {
+		out.reset(new io::Binary_stream(
+			get_surface_filename(Output_flags::Binary)
+		));
+	}
+	int n = 0;
+	for (int t0=0; t0<nt; t0+=n) {
+		n = std::min(block, nt - t0);
+		// the ranges may overlap when the block is shorter than the kernel,
+		// but forward copying is safe since the source follows the destination
+		if (history > 0 && t0 > 0) {
+			eps(Range(0, history-1), Range::all(), Range::all()) =
+				eps(Range(block, block+history-1), Range::all(), Range::all());
+		}
+		ARMA_PROFILE_START(generate_white_noise);
+		prng::generate_white_noise(eps_block, mts, dist);
+		ARMA_PROFILE_END(generate_white_noise);
+		if (use_direct) {
+			direct.convolve(eps, zeta);
+		} else {
+			signal = eps;
+			zeta = real(conv->convolve(signal, kernel));
+		}
+		zeta_block *= scale;
+		/// Moments of the time slices are merged in order.
+		#if ARMA_OPENMP
+		#pragma omp parallel for
+		#endif
+		for (int i=0; i<n; ++i) {
+			const int t = t0 + i;
+			slice_moments[i] = t < lo(0)
+				? stats::Moments<T>()
+				: stats::moments(zeta(RectDomain<3>(
+					Shape3D(history + i, lo(1), lo(2)),
+					Shape3D(history + i, hi(1), hi(2))
+				)));
+		}
+		for (int i=0; i<n; ++i) {
+			this->_moments += slice_moments[i];
+		}
+		if (out) {
+			ARMA_EVENT_START("write_surface", "io", 0);
+			out->write(zeta, history, n);
+			ARMA_EVENT_END("write_surface", "io", 0);
+		}
+		print_progress("wrote slice", t0+n, nt);
+	}
+	Array3D<T> result(Shape3D(n, shape(1), shape(2)));
+	result = zeta(Range(history, history+n-1), Range::all(), Range::all());
+	return result;
+}
+
 template <class T>
 void
 arma::generator::MA_model<T>
@@ -67,6 +217,8 @@ arma::generator::MA_model<T>
 	typedef typename Basic_model<T>::grid_type grid_type;
 	sys::parameter_map params({
 	                              {"algorithm", sys::make_param(this->_algo)},
+	                              {"time_block", sys::make_param(this->_timeblock)},
+	                              {"trace", sys::make_param(this->_trace)},
 							  }, true);
 	params.insert(this->parameters());
 	in >> params;
@@ -76,6 +228,20 @@ arma::generator::MA_model<T>
 		this->_acf.grid().delta() * this->_outgrid.num_patches()
 	                 );
 	this->_theta.resize(this->order());
+	if (this->_timeblock > 0) {
+		/// Without binary output all blocks except the last one are lost.
+		if (!this->_oflags.isset(Output_flags::Binary)) {
+			std::cerr << "MA model \"time_block\" requires \"binary\" output"
+				<< std::endl;
+			throw std::invalid_argument("bad time_block");
+		}
+		/// NIT needs the ACF of the whole surface.
+		if (!this->_linear) {
+			std::cerr << "MA model \"time_block\" is not supported "
+				"with non-linear transform" << std::endl;
+			throw std::invalid_argument("bad time_block");
+		}
+	}
 }
 
 template <class T>
@@ -86,7 +252,8 @@ arma::generator::MA_model<T>
 	    << ",order=" << this->order()
 	    << ",output=" << this->_oflags
 	    << ",acf.shape=" << this->_acf.shape()
-	    << ",algorithm=" << this->_algo;
+	    << ",algorithm=" << this->_algo
+	    << ",time_block=" << this->_timeblock;
 }
 
 template <class T>
@@ -95,14 +262,37 @@ arma::generator::MA_model<T>
 ::determine_coefficients() {
 	switch (this->_algo) {
 	case MA_algorithm::Fixed_point_iteration:
-		this->fixed_point_iteration();
+	case MA_algorithm::Newton_Raphson:
+		this->solve_coefficients();
 		break;
 	default:
-		throw std::runtime_error("only fixed_point_iteration is supported");
+		throw std::runtime_error("bad MA algorithm");
 		break;
 	}
 }
 
+template <class T>
+void
+arma::generator::MA_model<T>
+::write_cache_key(std::ostream& out) const {
+	Basic_ARMA_model<T>::write_cache_key(out);
+	out << ",algorithm=" << this->_algo;
+}
+
+template <class T>
+void
+arma::generator::MA_model<T>
+::save_coefficients(std::ostream& out) const {
+	out << this->_theta;
+}
+
+template <class T>
+void
+arma::generator::MA_model<T>
+::load_coefficients(std::istream& in) {
+	in >> this->_theta;
+}
+
 template <class T>
 void
 arma::generator::MA_model<T>
@@ -153,14 +343,28 @@ arma::generator::MA_model<T>
 template <class T>
 void
 arma::generator::MA_model<T>
-::fixed_point_iteration() {
-	using blitz::RectDomain;
+::solve_coefficients() {
 	MA_coefficient_solver<T> solver(
 		Array3D<T>(this->_acf),
 		this->_order
 	);
+	solver.algorithm(this->_algo);
+	std::ofstream trace;
+	if (this->_trace) {
+		trace.open("theta_all");
+		solver.trace(trace);
+	}
 	this->_theta.reference(solver.solve());
 	this->_varwn = solver.white_noise_variance(this->_theta);
+	if (this->_trace) {
+		this->write_coefficients();
+	}
+}
+
+template <class T>
+void
+arma::generator::MA_model<T>
+::write_coefficients() const {
 	{ std::ofstream("theta") << this->_theta; }
 	{
 		std::ofstream out("theta.dat");
@@ -26,6 +26,17 @@ namespace arma {
 			Array3D<T> _theta;
 			/// The algorithm that determines MA model coefficients.
 			MA_algorithm _algo = MA_algorithm::Fixed_point_iteration;
+			/**
+			The number of time slices generated at once in streaming mode.
+			Streaming is disabled when it is nought.
+			*/
+			int _timeblock = 0;
+			/**
+			Write the coefficients of each iteration of the solver to
+			"theta_all" file and the final coefficients to "theta" and
+			"theta.dat" files.
+			*/
+			bool _trace = false;
 
 		public:
 
@@ -45,6 +56,18 @@ namespace arma {
 			void
 			validate() const override;
 
+			/// Time slices are written to the binary file as they are generated.
+			bool
+			writes_in_parallel() const noexcept override {
+				return this->_timeblock > 0 &&
+					this->oflags().isset(Output_flags::Binary);
+			}
+
+			inline bool
+			generates_in_blocks() const noexcept override {
+				return this->_timeblock > 0;
+			}
+
 			void
 			determine_coefficients() override;
 
@@ -76,15 +99,48 @@ namespace arma {
 			void
 			read(std::istream& in) override;
 
+			inline bool
+			caches_coefficients() const noexcept override {
+				return true;
+			}
+
+			void
+			write_cache_key(std::ostream& out) const override;
+
+			void
+			save_coefficients(std::ostream& out) const override;
+
+			void
+			load_coefficients(std::istream& in) override;
+
 		private:
 
 			/**
-			   Solve nonlinear system with fixed-point iteration algorithm to
-			      find
+			Generate the surface block by block along time axis
+			using overlap-save method: each block of white noise is
+			prepended with the last \f$n_t-1\f$ time slices of the
+			previous block, the convolution of the first \f$n_t-1\f$
+			slices is discarded. Only one block of white noise and of
+			the surface is held in memory at any time, finished blocks
+			are written to the binary file, and the last block is returned.
+			*/
+			Array3D<T>
+			generate_streaming();
+
+			/// Convolution kernel \f$(1,-\theta_1,-\theta_2,\ldots)\f$.
+			Array3D<T>
+			convolution_kernel() const;
+
+			/**
+			   Solve nonlinear system with fixed-point iteration algorithm
+			   or Newton---Raphson method to find
 			   moving-average coefficients \f$\theta\f$.
 			 */
 			void
-			fixed_point_iteration();
+			solve_coefficients();
+
+			void
+			write_coefficients() const;
 
 			void
 			recompute_acf(Array3D<T> acf_orig, Array3D<T> phi);
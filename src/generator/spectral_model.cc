@@ -0,0 +1,117 @@
+#include "spectral_model.hh"
+
+#include "fourier.hh"
+#include "params.hh"
+#include "profile.hh"
+#include "util.hh"
+
+#include <complex>
+#include <iostream>
+#include <stdexcept>
+
+template <class T>
+void
+arma::generator::Spectral_model<T>
+::validate() const {
+	if (!(blitz::max(this->_filter) > T(0))) {
+		throw std::runtime_error("spectrum is not positive");
+	}
+}
+
+template <class T>
+void
+arma::generator::Spectral_model<T>
+::determine_coefficients() {
+	using blitz::abs;
+	using blitz::all;
+	using blitz::real;
+	using blitz::sqrt;
+	using blitz::sum;
+	using blitz::where;
+	typedef std::complex<T> C;
+	const Shape3D shape = this->grid().num_points();
+	const Shape3D acf_shape = this->_acf.shape();
+	if (!all(2*acf_shape - 1 <= shape)) {
+		std::cerr << "ACF shape = " << acf_shape
+			<< ", output grid shape = " << shape << std::endl;
+		throw std::length_error("output grid is too small for the ACF");
+	}
+	/// 1. Extend the ACF to the torus of the output grid size
+	/// assuming that it is symmetric along each dimension.
+	Array3D<C> spectrum(shape);
+	const int nt = acf_shape(0);
+	const int nx = acf_shape(1);
+	const int ny = acf_shape(2);
+	for (int i=0; i<nt; ++i) {
+		for (int j=0; j<nx; ++j) {
+			for (int k=0; k<ny; ++k) {
+				const T r = this->_acf(i,j,k);
+				for (int i1 : {i, (shape(0)-i) % shape(0)}) {
+					for (int j1 : {j, (shape(1)-j) % shape(1)}) {
+						for (int k1 : {k, (shape(2)-k) % shape(2)}) {
+							spectrum(i1,j1,k1) = r;
+						}
+					}
+				}
+			}
+		}
+	}
+	/// 2. Take the square root of the spectrum clipping negative values
+	/// which appear due to truncation of the ACF.
+	apmath::Fourier_transform<C,3> fft(shape);
+	fft.forward(spectrum);
+	Array3D<T> s(shape);
+	s = real(spectrum);
+	spectrum.free();
+	const T total = sum(abs(s));
+	const T negative = -sum(where(s < T(0), s, T(0)));
+	this->_filter.resize(shape);
+	this->_filter = sqrt(where(s > T(0), s, T(0)));
+	write_key_value(
+		std::clog,
+		"Clipped spectrum",
+		total > T(0) ? negative/total : T(0)
+	);
+	this->_varwn = T(1);
+}
+
+template <class T>
+arma::Array3D<T>
+arma::generator::Spectral_model<T>
+::do_generate() {
+	using blitz::real;
+	typedef std::complex<T> C;
+	ARMA_PROFILE_START(generate_white_noise);
+	Array3D<T> eps = this->generate_white_noise();
+	ARMA_PROFILE_END(generate_white_noise);
+	const Shape3D shape = eps.shape();
+	Array3D<C> signal(shape);
+	signal = eps;
+	eps.free();
+	apmath::Fourier_transform<C,3> fft(shape);
+	fft.forward(signal);
+	signal *= this->_filter;
+	fft.backward(signal);
+	Array3D<T> zeta(shape);
+	zeta = real(signal) / T(signal.numElements());
+	return zeta;
+}
+
+template <class T>
+void
+arma::generator::Spectral_model<T>
+::read(std::istream& in) {
+	sys::parameter_map params(this->parameters(), true);
+	in >> params;
+}
+
+template <class T>
+void
+arma::generator::Spectral_model<T>
+::write(std::ostream& out) const {
+	out << "grid=" << this->grid()
+	    << ",output=" << this->_oflags
+	    << ",acf.shape=" << this->_acf.shape();
+}
+
+template class arma::generator::Spectral_model<ARMA_REAL_TYPE>;
@@ -0,0 +1,96 @@
+#ifndef GENERATOR_SPECTRAL_MODEL_HH
+#define GENERATOR_SPECTRAL_MODEL_HH
+
+#include "basic_arma_model.hh"
+#include "discrete_function.hh"
+#include "types.hh"
+
+namespace arma {
+
+	namespace generator {
+
+		/**
+		\brief Filters white noise with the square root of the spectrum
+		of the ACF, producing periodic wavy surface.
+
+		The ACF is extended to the torus of the output grid size by
+		symmetry, its Fourier transform gives the spectrum \f$S\f$ of the
+		process, and the surface is computed as
+		\f[
+			\zeta = \mathcal{F}^{-1}\left[\sqrt{S}\,\mathcal{F}\left[\epsilon\right]\right],
+		\f]
+		where \f$\epsilon\f$ is white noise with unit variance. Unlike AR
+		and MA models the process is not causal, but generation takes
+		\f$O(N\log N)\f$ operations and all of them are parallel.
+		\ingroup generators
+		*/
+		template <class T>
+		class Spectral_model: public Basic_ARMA_model<T> {
+
+		public:
+			typedef Discrete_function<T,3> acf_type;
+
+		private:
+			/// Square root of the spectrum on the output grid.
+			Array3D<T> _filter;
+
+		public:
+
+			Spectral_model() = default;
+
+			inline explicit
+			Spectral_model(acf_type acf):
+			Basic_ARMA_model<T>(acf, acf.shape())
+			{}
+
+			inline Array3D<T>
+			filter() const {
+				return this->_filter;
+			}
+
+			void
+			validate() const override;
+
+			void
+			determine_coefficients() override;
+
+			template <class X>
+			friend std::ostream&
+			operator<<(std::ostream& out, const Spectral_model<X>& rhs);
+
+			template <class X>
+			friend std::istream&
+			operator>>(std::istream& in, Spectral_model<X>& rhs);
+
+		protected:
+
+			Array3D<T>
+			do_generate() override;
+
+			void
+			write(std::ostream& out) const override;
+
+			void
+			read(std::istream& in) override;
+
+		};
+
+		template <class T>
+		std::ostream&
+		operator<<(std::ostream& out, const Spectral_model<T>& rhs) {
+			rhs.Spectral_model<T>::write(out);
+			return out;
+		}
+
+		template <class T>
+		std::istream&
+		operator>>(std::istream& in, Spectral_model<T>& rhs) {
+			rhs.Spectral_model<T>::read(in);
+			return in;
+		}
+
+	}
+
+}
+
+#endif // GENERATOR_SPECTRAL_MODEL_HH
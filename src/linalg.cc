@@ -78,6 +78,78 @@ namespace {
 		}
 	}
 
+	template <
+		class T,
+		lapack_int (*getrf)(
+			int matrix_layout,
+			lapack_int m,
+			lapack_int n,
+			T* a,
+			lapack_int lda,
+			lapack_int* ipiv
+		)
+	>
+	void
+	do_lu_factorise(linalg::Matrix<T>& A, linalg::Vector<int>& ipiv) {
+		static_assert(
+			sizeof(lapack_int) == sizeof(int),
+			"bad lapack_int size"
+		);
+		const int n = A.rows();
+		assert(n == A.cols());
+		assert(A.isStorageContiguous());
+		const int info = getrf(
+			LAPACK_ROW_MAJOR,
+			n,
+			n,
+			A.data(),
+			n,
+			reinterpret_cast<lapack_int*>(ipiv.data())
+		);
+		if (info != 0) {
+			std::cerr << "getrf info=" << info << std::endl;
+			throw std::runtime_error("getrf error");
+		}
+	}
+
+	template <
+		class T,
+		lapack_int (*getrs)(
+			int matrix_layout,
+			char trans,
+			lapack_int n,
+			lapack_int nrhs,
+			const T* a,
+			lapack_int lda,
+			const lapack_int* ipiv,
+			T* b,
+			lapack_int ldb
+		)
+	>
+	void
+	do_lu_solve(
+		const linalg::Matrix<T>& LU,
+		const linalg::Vector<int>& ipiv,
+		T* b,
+		int nrhs
+	) {
+		const int n = LU.rows();
+		const int info = getrs(
+			LAPACK_ROW_MAJOR,
+			'N',
+			n,
+			nrhs,
+			LU.data(),
+			n,
+			reinterpret_cast<const lapack_int*>(ipiv.data()),
+			b,
+			nrhs
+		);
+		if (info != 0) {
+			throw std::runtime_error("getrs error");
+		}
+	}
+
 	template <class T, class Factor, class Inverse>
 	void
 	do_inverse_symmetric(linalg::Matrix<T>& A, Factor sytrf, Inverse sytri) {
@@ -144,6 +216,57 @@ namespace linalg {
 	inverse_symmetric(Matrix<double>& A) {
 		do_inverse_symmetric<double>(A,LAPACKE_dsytrf,LAPACKE_dsytri);
 	}
+
+	template <>
+	void
+	LU_factorisation<float>::getrf() {
+		do_lu_factorise<float,LAPACKE_sgetrf>(this->_lu, this->_ipiv);
+	}
+
+	template <>
+	void
+	LU_factorisation<double>::getrf() {
+		do_lu_factorise<double,LAPACKE_dgetrf>(this->_lu, this->_ipiv);
+	}
+
+	template <>
+	void
+	LU_factorisation<float>::getrs(float* b, int nrhs) const {
+		do_lu_solve<float,LAPACKE_sgetrs>(this->_lu, this->_ipiv, b, nrhs);
+	}
+
+	template <>
+	void
+	LU_factorisation<double>::getrs(double* b, int nrhs) const {
+		do_lu_solve<double,LAPACKE_dgetrs>(this->_lu, this->_ipiv, b, nrhs);
+	}
+
+}
+
+template <class T>
+void
+linalg::LU_factorisation<T>::factorise(const Matrix<T>& A) {
+	assert(A.rows() == A.cols());
+	// allocate new storage, the old one may be shared with copies
+	this->_lu.reference(A.copy());
+	this->_ipiv.reference(Vector<int>(A.rows()));
+	this->getrf();
+}
+
+template <class T>
+void
+linalg::LU_factorisation<T>::solve(Matrix<T>& B) const {
+	assert(B.rows() == this->size());
+	assert(B.isStorageContiguous());
+	this->getrs(B.data(), B.cols());
+}
+
+template <class T>
+void
+linalg::LU_factorisation<T>::solve(Vector<T>& b) const {
+	assert(b.extent(0) == this->size());
+	assert(b.isStorageContiguous());
+	this->getrs(b.data(), 1);
 }
 
 
@@ -263,6 +386,9 @@ linalg::operator<<(std::ostream& out, const Bisection<T>& rhs) {
 		<< ",niterations=" << rhs._niterations;
 }
 
+template class linalg::LU_factorisation<float>;
+template class linalg::LU_factorisation<double>;
+
 template bool linalg::is_symmetric<ARMA_REAL_TYPE>(Matrix<ARMA_REAL_TYPE>& rhs);
 template bool linalg::is_positive_definite<ARMA_REAL_TYPE>(Matrix<ARMA_REAL_TYPE>& rhs);
 template bool linalg::is_toeplitz<ARMA_REAL_TYPE>(Matrix<ARMA_REAL_TYPE>& rhs);
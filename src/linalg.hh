@@ -52,6 +52,67 @@ namespace linalg {
 	void
 	inverse_symmetric(Matrix<T>& A);
 
+	/**
+	\brief LU factorisation of a square matrix that is computed once and
+	is used to solve linear systems with many right-hand sides.
+
+	Solving a system costs \f$O(n^2)\f$ per right-hand side
+	which is cheaper and more accurate than multiplication by
+	the explicit inverse.
+	*/
+	template <class T>
+	class LU_factorisation {
+
+		/// Unit lower and upper triangular factors stored in one matrix.
+		Matrix<T> _lu;
+		/// Row permutation.
+		Vector<int> _ipiv;
+
+	public:
+
+		LU_factorisation() = default;
+
+		LU_factorisation(const LU_factorisation&) = default;
+
+		LU_factorisation&
+		operator=(const LU_factorisation&) = delete;
+
+		/// Factorises a copy of matrix \p A.
+		inline explicit
+		LU_factorisation(const Matrix<T>& A) {
+			this->factorise(A);
+		}
+
+		/// Factorises a copy of matrix \p A replacing previous factors.
+		void
+		factorise(const Matrix<T>& A);
+
+		/**
+		\brief Solve \f$A X = B\f$ in place.
+		\param[in,out] B right-hand sides (one per column) and the solution.
+		*/
+		void
+		solve(Matrix<T>& B) const;
+
+		/// \copydoc solve
+		void
+		solve(Vector<T>& b) const;
+
+		inline int
+		size() const noexcept {
+			return this->_lu.rows();
+		}
+
+	private:
+
+		void
+		getrf();
+
+		void
+		getrs(T* b, int nrhs) const;
+
+	};
+
 	template <int N>
 	blitz::Array<float,N>
 	multiply_mv(Matrix<float> lhs, blitz::Array<float,N> rhs) {
@@ -258,6 +319,11 @@ namespace linalg {
 			return this->_niterations;
 		}
 
+		inline T
+		eps() const noexcept {
+			return this->_eps;
+		}
+
 		template <class X>
 		friend std::istream&
 		operator>>(std::istream& in, Bisection<X>& rhs);
@@ -0,0 +1,103 @@
+#ifndef NONLINEAR_MONOTONE_SPLINE_HH
+#define NONLINEAR_MONOTONE_SPLINE_HH
+
+#include <algorithm>
+#include <cmath>
+
+#include <blitz/array.h>
+
+namespace arma {
+
+	namespace nonlinear {
+
+		/**
+		\brief Piecewise cubic Hermite interpolation (PCHIP) of monotone
+		function on uniform grid.
+
+		Derivatives in the nodes are harmonic means of the adjacent
+		slopes \cite Fritsch1984, which preserves monotonicity of
+		the data and does not overshoot. The evaluation needs
+		only one multiplication to find the interval.
+		*/
+		template <class T>
+		class Monotone_spline {
+
+		public:
+			typedef blitz::Array<T,1> array_type;
+
+		private:
+			/// The first node.
+			T _x0 = 0;
+			/// The last node.
+			T _x1 = 0;
+			/// Distance between nodes.
+			T _h = 0;
+			/// Inverse distance between nodes.
+			T _invh = 0;
+			/// Function values in the nodes.
+			array_type _y;
+			/// Derivatives multiplied by the distance between nodes.
+			array_type _d;
+
+		public:
+
+			Monotone_spline() = default;
+
+			/**
+			\param[in] x0 the first node
+			\param[in] x1 the last node
+			\param[in] y function values in uniformly distributed nodes
+			*/
+			Monotone_spline(T x0, T x1, const array_type& y):
+			_x0(x0),
+			_x1(x1),
+			_h((x1-x0)/(y.numElements()-1)),
+			_invh(T(1)/_h),
+			_y(y.copy()),
+			_d(y.numElements())
+			{
+				const int n = this->_y.numElements();
+				this->_d(0) = this->_y(1) - this->_y(0);
+				this->_d(n-1) = this->_y(n-1) - this->_y(n-2);
+				for (int i=1; i<n-1; ++i) {
+					const T d0 = this->_y(i) - this->_y(i-1);
+					const T d1 = this->_y(i+1) - this->_y(i);
+					this->_d(i) = (d0*d1 > T(0)) ? T(2)*d0*d1/(d0+d1) : T(0);
+				}
+			}
+
+			/// Returns true if the spline is defined in the point.
+			inline bool
+			contains(T x) const noexcept {
+				return this->_x0 <= x && x <= this->_x1;
+			}
+
+			inline T
+			operator()(T x) const noexcept {
+				const int n = this->_y.numElements();
+				const T s = (x - this->_x0)*this->_invh;
+				const int i = std::min(std::max(int(s), 0), n-2);
+				const T t = s - T(i);
+				const T t2 = t*t;
+				const T t3 = t2*t;
+				const T h00 = T(2)*t3 - T(3)*t2 + T(1);
+				const T h10 = t3 - T(2)*t2 + t;
+				const T h01 = T(3)*t2 - T(2)*t3;
+				const T h11 = t3 - t2;
+				return h00*this->_y(i) + h10*this->_d(i)
+					+ h01*this->_y(i+1) + h11*this->_d(i+1);
+			}
+
+			/// The number of nodes.
+			inline int
+			size() const noexcept {
+				return this->_y.numElements();
+			}
+
+		};
+
+	}
+
+}
+
+#endif // NONLINEAR_MONOTONE_SPLINE_HH
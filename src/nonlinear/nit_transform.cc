@@ -9,6 +9,7 @@
 #include "opencl/vec.hh"
 #endif
 
+#include <algorithm>
 #include <string>
 #include <stdexcept>
 #include <iostream>
@@ -23,7 +24,8 @@ namespace {
 		arma::Array3D<T> acf,
 		arma::Array3D<T>& realisation,
 		const Solver& solver,
-		const Distribution& dist
+		const Distribution& dist,
+		const T scale
 	) {
 		using namespace arma;
 		cl::Kernel kernel = opencl::get_kernel("transform_data_gram_charlier");
@@ -31,7 +33,7 @@ namespace {
 		kernel.setArg(1, solver.interval().first());
 		kernel.setArg(2, solver.interval().last());
 		kernel.setArg(3, solver.num_iterations());
-		kernel.setArg(4, std::sqrt(acf(0,0,0)));
+		kernel.setArg(4, std::sqrt(acf(0,0,0)) / scale);
 		kernel.setArg(5, dist.skewness());
 		kernel.setArg(6, dist.kurtosis());
 		realisation.compute(kernel);
@@ -128,7 +130,8 @@ template <class T>
 void
 arma::nonlinear::NIT_transform<T>::transform_realisation(
 	Array3D<T> acf,
-	Array3D<T>& realisation
+	Array3D<T>& realisation,
+	T scale
 ) {
 	switch (_targetdist) {
 		case Distribution::Gram_Charlier:
@@ -137,14 +140,25 @@ arma::nonlinear::NIT_transform<T>::transform_realisation(
 				acf,
 				realisation,
 				this->_cdfsolver,
-				this->_gramcharlier
+				this->_gramcharlier,
+				scale
 			);
 			#else
-			do_transform_realisation(acf, realisation, this->_gramcharlier);
+			do_transform_realisation(
+				acf,
+				realisation,
+				this->_gramcharlier,
+				scale
+			);
 			#endif
 			break;
 		case Distribution::Skew_normal:
-			do_transform_realisation(acf, realisation, this->_skewnormal);
+			do_transform_realisation(
+				acf,
+				realisation,
+				this->_skewnormal,
+				scale
+			);
 			break;
 	}
 }
@@ -155,15 +169,50 @@ void
 arma::nonlinear::NIT_transform<T>::do_transform_realisation(
 	Array3D<T> acf,
 	Array3D<T>& realisation,
-	Dist& dist
+	Dist& dist,
+	T scale
 ) {
 	const T stdev = std::sqrt(acf(0,0,0));
+	if (this->_splineintervals == 0) {
+		/// CDF of the scaled point is equal to CDF of the point with
+		/// the standard deviation divided by the scale.
+		transform_data(
+			realisation.data(),
+			realisation.numElements(),
+			normaldist_type(T(0), stdev / scale),
+			dist,
+			this->_cdfsolver
+		);
+		return;
+	}
+	/// Compute spline nodes more precisely than individual points.
+	const auto& iv = this->_cdfsolver.interval();
+	const T eps = this->_cdfsolver.eps();
+	const solver_type solver(
+		iv.first(),
+		iv.last(),
+		eps*T(1e-3),
+		std::max(this->_cdfsolver.num_iterations(), 60)
+	);
+	T err = 0;
+	Monotone_spline<T> spline = make_transform_spline(
+		normaldist_type(T(0), stdev),
+		dist,
+		solver,
+		eps,
+		int(this->_splineintervals),
+		err
+	);
+	write_key_value(std::clog, "NIT spline nodes", spline.size());
+	write_key_value(std::clog, "NIT spline error", err);
 	transform_data(
 		realisation.data(),
 		realisation.numElements(),
 		normaldist_type(T(0), stdev),
 		dist,
-		this->_cdfsolver
+		this->_cdfsolver,
+		spline,
+		scale
 	);
 }
 
@@ -230,6 +279,7 @@ arma::nonlinear::operator<<(std::ostream& out, const NIT_transform<T>& rhs) {
 		<< ",interpolation_nodes=" << rhs._intnodes
 		<< ",max_interpolation_order=" << rhs._maxintorder
 		<< ",max_expansion_order=" << rhs._maxexpansionorder
+		<< ",spline_intervals=" << rhs._splineintervals
 		;
 	return out;
 }
@@ -256,6 +306,7 @@ arma::nonlinear::operator>>(std::istream& in, NIT_transform<T>& rhs) {
 			"max_expansion_order",
 			sys::make_param(rhs._maxexpansionorder, validate_positive<T>)
 	    },
+	    {"spline_intervals", sys::make_param(rhs._splineintervals)},
 	    {"cdf_solver", sys::make_param(rhs._cdfsolver)},
 	    {"acf_solver", sys::make_param(rhs._acfsolver)},
 	}, "nit_transform", true);
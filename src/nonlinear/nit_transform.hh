@@ -56,6 +56,12 @@ namespace arma {
 			unsigned int _intnodes = 100;
 			unsigned int _maxintorder = default_interpolation_order;
 			unsigned int _maxexpansionorder = default_gram_charlier_order;
+			/**
+			Maximal number of intervals of the spline that approximates
+			the transformation of realisation. All points are transformed
+			with the solver when nought.
+			*/
+			unsigned int _splineintervals = 65536;
 			solver_type _cdfsolver, _acfsolver;
 			Array1D<T> _xnodes, _ynodes;
 
@@ -68,8 +74,18 @@ namespace arma {
 			void
 			transform_ACF(Array3D<T>& acf);
 
+			/**
+			\param[in] acf the ACF of the realisation
+			\param[in,out] realisation the realisation
+			\param[in] scale the factor each point is multiplied by
+			before the transformation
+			*/
 			void
-			transform_realisation(Array3D<T> acf, Array3D<T>& realisation);
+			transform_realisation(
+				Array3D<T> acf,
+				Array3D<T>& realisation,
+				T scale = T(1)
+			);
 
 			template <class X>
 			friend std::ostream&
@@ -91,7 +107,8 @@ namespace arma {
 			do_transform_realisation(
 				Array3D<T> acf,
 				Array3D<T>& realisation,
-				Dist& dist
+				Dist& dist,
+				T scale
 			);
 
 			void
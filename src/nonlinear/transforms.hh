@@ -1,9 +1,13 @@
 #ifndef NONLINEAR_TRANSFORMS_HH
 #define NONLINEAR_TRANSFORMS_HH
 
+#include <algorithm>
+#include <cmath>
 #include <utility>
+#include <vector>
 #include "equations.hh"
 #include "linalg.hh"
+#include "monotone_spline.hh"
 
 namespace arma {
 
@@ -50,10 +54,57 @@ namespace arma {
 			return std::make_pair(x, y);
 		}
 
+		/// The number of points for which CDF is computed at once.
+		constexpr const int cdf_batch_size = 64;
+
+		/**
+		\brief Solves \f$F(x_i)=y_i\f$ for each of \f$n\leq 64\f$ points
+		with bisection method on the solver interval.
+
+		Bisection steps are made for all points simultaneously, so that
+		CDF of the whole batch is computed with one call.
+		*/
+		template <class T, class Dist, class Solver>
+		void
+		solve_CDF_batch(
+			const T* y,
+			T* x,
+			const int n,
+			const Dist& dist,
+			const Solver& solver
+		) {
+			T lo[cdf_batch_size], hi[cdf_batch_size], f[cdf_batch_size];
+			const T a = solver.interval().first();
+			const T b = solver.interval().last();
+			const T eps = solver.eps();
+			for (int i=0; i<n; ++i) {
+				lo[i] = a;
+				hi[i] = b;
+				x[i] = T(0.5)*(a + b);
+			}
+			const int max_iterations = solver.num_iterations();
+			T width = b - a;
+			for (int it=0; it<max_iterations && width > eps; ++it) {
+				dist.cdf(x, f, n);
+				#if ARMA_OPENMP
+				#pragma omp simd
+				#endif
+				for (int i=0; i<n; ++i) {
+					const bool left = f[i] < y[i];
+					lo[i] = left ? x[i] : lo[i];
+					hi[i] = left ? hi[i] : x[i];
+					x[i] = T(0.5)*(lo[i] + hi[i]);
+				}
+				width *= T(0.5);
+			}
+		}
+
 		/**
 		\brief Transforms each data point from old to new distribution.
 		\date 2017-05-20
 		\author Ivan Gankevich
+
+		CDFs are computed for batches of points.
 		*/
 		template <class T, class Dist1, class Dist2, class Solver>
 		void
@@ -64,13 +115,132 @@ namespace arma {
 			Dist2 new_dist,
 			Solver solver
 		) {
+			const int nbatches = (n + cdf_batch_size - 1) / cdf_batch_size;
 			#if ARMA_OPENMP
 			#pragma omp parallel for
 			#endif
-			for (int i=0; i<n; ++i) {
-				data[i] = solver(
-					Equation_CDF<T, Dist2>(new_dist, old_dist.cdf(data[i]))
-				);
+			for (int batch=0; batch<nbatches; ++batch) {
+				T* x = data + batch*cdf_batch_size;
+				const int nb = std::min(cdf_batch_size, n - batch*cdf_batch_size);
+				T y[cdf_batch_size];
+				old_dist.cdf(x, y, nb);
+				solve_CDF_batch(y, x, nb, new_dist, solver);
+			}
+		}
+
+		/**
+		\brief Approximates transformation of each data point from old to new
+		distribution with monotone spline.
+
+		The spline is built on the solver interval. The number of nodes
+		is doubled until the maximal difference between the spline and
+		the solution in the midpoints is less than \f$\epsilon\f$
+		or the number of nodes reaches the maximum. The midpoints
+		become the nodes of the next spline, so that each solution is
+		computed only once.
+
+		\param[in] old_dist current cumulative distribution function
+		\param[in] new_dist desired cumulative distribution function
+		\param[in] solver equation solver
+		\param[in] eps maximal absolute error of the spline
+		\param[in] max_intervals maximal number of spline intervals
+		\param[out] err the error of the resulting spline
+		*/
+		template <class T, class Dist1, class Dist2, class Solver>
+		Monotone_spline<T>
+		make_transform_spline(
+			Dist1 old_dist,
+			Dist2 new_dist,
+			Solver solver,
+			const T eps,
+			const int max_intervals,
+			T& err
+		) {
+			typedef blitz::Array<T,1> array_type;
+			const T x0 = solver.interval().first();
+			const T x1 = solver.interval().last();
+			/// Transform points \f$x_0 + (x_1-x_0)(i+\delta)/m\f$.
+			auto solve = [&] (array_type& y, int m, T delta) {
+				const int n = y.numElements();
+				for (int i=0; i<n; ++i) {
+					y(i) = x0 + (x1-x0)*(T(i) + delta)/T(m);
+				}
+				transform_data(y.data(), n, old_dist, new_dist, solver);
+			};
+			int m = std::min(64, max_intervals);
+			array_type y(m+1);
+			solve(y, m, T(0));
+			while (true) {
+				Monotone_spline<T> spline(x0, x1, y);
+				array_type ymid(m);
+				solve(ymid, m, T(0.5));
+				T max_err = 0;
+				for (int i=0; i<m; ++i) {
+					const T x = x0 + (x1-x0)*(T(i) + T(0.5))/T(m);
+					max_err = std::max(max_err, std::abs(spline(x) - ymid(i)));
+				}
+				err = max_err;
+				if (!(max_err > eps) || 2*m > max_intervals) {
+					return spline;
+				}
+				array_type new_y(2*m+1);
+				for (int i=0; i<m; ++i) {
+					new_y(2*i) = y(i);
+					new_y(2*i+1) = ymid(i);
+				}
+				new_y(2*m) = y(m);
+				y.reference(new_y);
+				m *= 2;
+			}
+		}
+
+		/**
+		\brief Transforms each data point from old to new distribution
+		using monotone spline.
+
+		Points outside of the spline interval are transformed
+		with the solver. Each point is multiplied by the scale before
+		the transformation, which saves a separate pass over the data.
+		*/
+		template <class T, class Dist1, class Dist2, class Solver>
+		void
+		transform_data(
+			T* data,
+			const int n,
+			Dist1 old_dist,
+			Dist2 new_dist,
+			Solver solver,
+			const Monotone_spline<T>& spline,
+			const T scale = T(1)
+		) {
+			const int nbatches = (n + cdf_batch_size - 1) / cdf_batch_size;
+			#if ARMA_OPENMP
+			#pragma omp parallel for
+			#endif
+			for (int batch=0; batch<nbatches; ++batch) {
+				T* x = data + batch*cdf_batch_size;
+				const int nb = std::min(cdf_batch_size, n - batch*cdf_batch_size);
+				T outside[cdf_batch_size];
+				int index[cdf_batch_size];
+				int noutside = 0;
+				for (int i=0; i<nb; ++i) {
+					x[i] *= scale;
+					if (spline.contains(x[i])) {
+						x[i] = spline(x[i]);
+					} else {
+						index[noutside] = i;
+						outside[noutside] = x[i];
+						++noutside;
+					}
+				}
+				if (noutside > 0) {
+					T y[cdf_batch_size];
+					old_dist.cdf(outside, y, noutside);
+					solve_CDF_batch(y, outside, noutside, new_dist, solver);
+					for (int i=0; i<noutside; ++i) {
+						x[index[i]] = outside[i];
+					}
+				}
 			}
 		}
 
@@ -79,6 +249,16 @@ namespace arma {
 		       Gram--Charlier series.
 		\date 2017-05-20
 		\author Ivan Gankevich
+
+		The equation is polynomial
+		\f$f(x)=\sum_i \frac{c_i^2}{i!} x^i\f$, and is solved with
+		Newton method safeguarded by bisection: the solution is bracketed
+		by the solver interval, and the step that leaves the bracket is
+		replaced with bisection step. The points are processed in batches,
+		and the polynomial and its derivative are evaluated with Horner
+		scheme for the whole batch at once. The points for which the
+		method does not converge in a few iterations or the interval does
+		not bracket the solution are solved with the solver.
 		*/
 		template <class T, class Solver>
 		void
@@ -88,13 +268,97 @@ namespace arma {
 			const blitz::Array<T,1> gram_charlier_coefs,
 			Solver solver
 		) {
+			const int batch_size = 64;
+			const int max_iterations = 10;
+			const int ncoefs = gram_charlier_coefs.numElements();
+			const T a = solver.interval().first();
+			const T b = solver.interval().last();
+			const T eps = solver.eps();
+			/// Compute polynomial coefficients \f$c_i^2/i!\f$.
+			std::vector<T> poly(std::max(ncoefs, 1), T(0));
+			T factorial = 1;
+			for (int i=0; i<ncoefs; ++i) {
+				const T c_i = gram_charlier_coefs(i);
+				poly[i] = c_i*c_i/factorial;
+				factorial *= (i+1);
+			}
+			const int m = poly.size();
+			auto polynomial = [&poly,m] (T x) {
+				T sum = 0;
+				for (int k=m-1; k>=0; --k) {
+					sum = sum*x + poly[k];
+				}
+				return sum;
+			};
+			const T f_a = polynomial(a);
+			const T f_b = polynomial(b);
+			const int nbatches = (n + batch_size - 1) / batch_size;
 			#if ARMA_OPENMP
 			#pragma omp parallel for
 			#endif
-			for (int i=0; i<n; ++i) {
-				data[i] = solver(
-					Equation_ACF<T>(gram_charlier_coefs, data[i])
-				);
+			for (int batch=0; batch<nbatches; ++batch) {
+				T* y = data + batch*batch_size;
+				const int nb = std::min(batch_size, n - batch*batch_size);
+				T x[batch_size], lo[batch_size], hi[batch_size];
+				T f[batch_size], df[batch_size], sign_lo[batch_size];
+				bool done[batch_size];
+				for (int j=0; j<nb; ++j) {
+					sign_lo[j] = (f_a - y[j]) < T(0) ? T(-1) : T(1);
+					done[j] = (f_a - y[j])*(f_b - y[j]) > T(0);
+					lo[j] = a;
+					hi[j] = b;
+					x[j] = T(0.5)*(a + b);
+				}
+				bool converged = false;
+				for (int it=0; it<max_iterations && !converged; ++it) {
+					/// Evaluate the polynomial and its derivative.
+					for (int j=0; j<nb; ++j) {
+						f[j] = poly[m-1];
+						df[j] = 0;
+					}
+					for (int k=m-2; k>=0; --k) {
+						const T p_k = poly[k];
+						#if ARMA_OPENMP
+						#pragma omp simd
+						#endif
+						for (int j=0; j<nb; ++j) {
+							df[j] = df[j]*x[j] + f[j];
+							f[j] = f[j]*x[j] + p_k;
+						}
+					}
+					converged = true;
+					for (int j=0; j<nb; ++j) {
+						if (done[j]) {
+							continue;
+						}
+						const T fx = f[j] - y[j];
+						if (fx*sign_lo[j] > T(0)) {
+							lo[j] = x[j];
+						} else {
+							hi[j] = x[j];
+						}
+						T x_new = x[j] - fx/df[j];
+						if (!(lo[j] < x_new && x_new < hi[j])) {
+							x_new = T(0.5)*(lo[j] + hi[j]);
+						}
+						done[j] = std::abs(x_new - x[j]) <= eps ||
+							std::abs(fx) <= eps;
+						x[j] = x_new;
+						converged = converged && done[j];
+					}
+				}
+				/// Fall back to the solver for the remaining points.
+				for (int j=0; j<nb; ++j) {
+					const T fx_a = f_a - y[j];
+					const T fx_b = f_b - y[j];
+					if (!done[j] || fx_a*fx_b > T(0)) {
+						y[j] = solver(
+							Equation_ACF<T>(gram_charlier_coefs, y[j])
+						);
+					} else {
+						y[j] = x[j];
+					}
+				}
 			}
 		}
 
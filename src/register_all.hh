@@ -12,6 +12,7 @@
 #include "generator/arma_model.hh"
 #include "generator/plain_wave_model.hh"
 #include "generator/lh_model.hh"
+#include "generator/spectral_model.hh"
 
 #include "velocity/high_amplitude_solver.hh"
 #include "velocity/linear_solver.hh"
@@ -65,6 +66,7 @@ register_all_models(arma::ARMA_driver<T>& drv) {
 	drv.template register_model<ARMA_model<T>>("ARMA");
 	drv.template register_model<Plain_wave_model<T>>("plain_wave");
 	drv.template register_model<Longuet_Higgins_model<T>>("LH");
+	drv.template register_model<Spectral_model<T>>("spectral");
 }
 
 #endif // vim:filetype=cpp
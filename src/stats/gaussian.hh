@@ -1,10 +1,13 @@
 #ifndef STATS_GAUSSIAN_HH
 #define STATS_GAUSSIAN_HH
 
+#include <cmath>
 #include <istream>
 #include <ostream>
 #include <gsl/gsl_cdf.h>
 
+#include "physical_constants.hh"
+
 namespace arma {
 
 	namespace stats {
@@ -42,6 +45,51 @@ namespace arma {
 				return gsl_cdf_gaussian_P(f - _mean, _sigma);
 			}
 
+			inline T
+			pdf(T x) const noexcept {
+				using constants::sqrt2pi;
+				const T z = (x - _mean) / _sigma;
+				return std::exp(T(-0.5)*z*z) / (_sigma*sqrt2pi<T>);
+			}
+
+			/// Computes quantile function for each of \f$n\f$ points.
+			inline void
+			quantile(const T* f, T* result, int n) const noexcept {
+				for (int i=0; i<n; ++i) {
+					result[i] = this->quantile(f[i]);
+				}
+			}
+
+			/// Computes CDF for each of \f$n\f$ points.
+			inline void
+			cdf(const T* x, T* result, int n) const noexcept {
+				using constants::sqrt2;
+				const T m = _mean;
+				const T s = T(-1) / (_sigma*sqrt2<T>);
+				#if ARMA_OPENMP
+				#pragma omp simd
+				#endif
+				for (int i=0; i<n; ++i) {
+					result[i] = T(0.5)*std::erfc((x[i] - m)*s);
+				}
+			}
+
+			/// Computes PDF for each of \f$n\f$ points.
+			inline void
+			pdf(const T* x, T* result, int n) const noexcept {
+				using constants::sqrt2pi;
+				const T m = _mean;
+				const T s = T(1) / _sigma;
+				const T c = s / sqrt2pi<T>;
+				#if ARMA_OPENMP
+				#pragma omp simd
+				#endif
+				for (int i=0; i<n; ++i) {
+					const T z = (x[i] - m)*s;
+					result[i] = c*std::exp(T(-0.5)*z*z);
+				}
+			}
+
 			T mean() const noexcept { return _mean; }
 			T stdev() const noexcept { return _sigma; }
 
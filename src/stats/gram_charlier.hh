@@ -43,6 +43,61 @@ namespace arma {
 					/ (T(24)*sqrt2pi<T>) + T(0.5)*std::erf(x/sqrt2<T>) + T(0.5);
 			}
 
+			/**
+			PDF is \f$\phi(x)\left(1 + \frac{\gamma_1}{6}He_3(x)
+			+ \frac{\gamma_2-3}{24}He_4(x)\right)\f$,
+			where \f$He_n\f$ are Hermite polynomials.
+			*/
+			inline T
+			pdf(T x) const noexcept {
+				T result;
+				this->pdf(&x, &result, 1);
+				return result;
+			}
+
+			/// Computes CDF for each of \f$n\f$ points.
+			inline void
+			cdf(const T* x, T* result, int n) const noexcept {
+				using namespace constants;
+				const T s = _skewness;
+				const T k = _kurtosis;
+				#if ARMA_OPENMP
+				#pragma omp simd
+				#endif
+				for (int i=0; i<n; ++i) {
+					const T x_i = x[i];
+					const T x2 = x_i*x_i;
+					result[i] = std::exp(T(-0.5)*x2)*(k*(T(3)*x_i - x2*x_i)
+						+ s*(T(4) - T(4)*x2) + T(3)*x2*x_i - T(9)*x_i)
+						/ (T(24)*sqrt2pi<T>)
+						+ T(0.5)*std::erf(x_i/sqrt2<T>) + T(0.5);
+				}
+			}
+
+			/**
+			Computes PDF for each of \f$n\f$ points. Hermite polynomials
+			are computed with recurrence
+			\f$He_{m+1}(x)=x He_m(x) - m He_{m-1}(x)\f$.
+			*/
+			inline void
+			pdf(const T* x, T* result, int n) const noexcept {
+				using namespace constants;
+				const T c3 = _skewness / T(6);
+				const T c4 = (_kurtosis - T(3)) / T(24);
+				#if ARMA_OPENMP
+				#pragma omp simd
+				#endif
+				for (int i=0; i<n; ++i) {
+					const T x_i = x[i];
+					const T he1 = x_i;
+					const T he2 = x_i*he1 - T(1);
+					const T he3 = x_i*he2 - T(2)*he1;
+					const T he4 = x_i*he3 - T(3)*he2;
+					result[i] = std::exp(T(-0.5)*x_i*x_i) / sqrt2pi<T>
+						* (T(1) + c3*he3 + c4*he4);
+				}
+			}
+
 			inline T
 			skewness() const noexcept {
 				return this->_skewness;
@@ -0,0 +1,137 @@
+#ifndef STATS_MOMENTS_HH
+#define STATS_MOMENTS_HH
+
+#include <cmath>
+#include <cstddef>
+
+#include <blitz/array.h>
+
+namespace arma {
+
+	namespace stats {
+
+		/**
+		\brief Mergeable accumulator of the first four moments.
+
+		Points are added one by one with Welford method, and accumulators
+		of disjoint parts of the data are merged with the formulae of
+		\cite Chan1983 generalised to higher moments \cite Pebay2008.
+		Neither requires the data to be stored or traversed twice,
+		and both are numerically stable. Skewness and kurtosis are
+		defined in the same way as in GSL.
+		*/
+		template <class T>
+		class Moments {
+
+			/// The number of points.
+			size_t _count = 0;
+			/// Sample mean.
+			T _mean = 0;
+			/// Sum of squared deviations from the mean.
+			T _m2 = 0;
+			/// Sum of cubed deviations from the mean.
+			T _m3 = 0;
+			/// Sum of deviations from the mean to the fourth power.
+			T _m4 = 0;
+
+		public:
+
+			inline void
+			push(T x) noexcept {
+				const T n1 = T(this->_count);
+				++this->_count;
+				const T n = T(this->_count);
+				const T delta = x - this->_mean;
+				const T delta_n = delta / n;
+				const T delta_n2 = delta_n*delta_n;
+				const T term = delta*delta_n*n1;
+				this->_mean += delta_n;
+				this->_m4 += term*delta_n2*(n*n - T(3)*n + T(3))
+					+ T(6)*delta_n2*this->_m2 - T(4)*delta_n*this->_m3;
+				this->_m3 += term*delta_n*(n - T(2)) - T(3)*delta_n*this->_m2;
+				this->_m2 += term;
+			}
+
+			Moments&
+			operator+=(const Moments& rhs) noexcept {
+				if (rhs._count == 0) {
+					return *this;
+				}
+				if (this->_count == 0) {
+					return *this = rhs;
+				}
+				const T na = T(this->_count);
+				const T nb = T(rhs._count);
+				const T n = na + nb;
+				const T delta = rhs._mean - this->_mean;
+				const T delta2 = delta*delta;
+				const T ma2 = this->_m2;
+				const T ma3 = this->_m3;
+				this->_mean += delta*nb/n;
+				this->_m4 += rhs._m4
+					+ delta2*delta2*na*nb*(na*na - na*nb + nb*nb)/(n*n*n)
+					+ T(6)*delta2*(na*na*rhs._m2 + nb*nb*ma2)/(n*n)
+					+ T(4)*delta*(na*rhs._m3 - nb*ma3)/n;
+				this->_m3 += rhs._m3
+					+ delta2*delta*na*nb*(na - nb)/(n*n)
+					+ T(3)*delta*(na*rhs._m2 - nb*ma2)/n;
+				this->_m2 += rhs._m2 + delta2*na*nb/n;
+				this->_count += rhs._count;
+				return *this;
+			}
+
+			/// \copydoc _count
+			inline size_t
+			count() const noexcept {
+				return this->_count;
+			}
+
+			/// \copydoc _mean
+			inline T
+			mean() const noexcept {
+				return this->_mean;
+			}
+
+			/// Unbiased sample variance.
+			inline T
+			variance() const noexcept {
+				return this->_count > 1 ? this->_m2 / T(this->_count - 1) : T(0);
+			}
+
+			inline T
+			stdev() const noexcept {
+				return std::sqrt(this->variance());
+			}
+
+			/// Sample skewness \f$\frac{1}{n}\sum(x_i-\mu)^3/\sigma^3\f$.
+			inline T
+			skewness() const noexcept {
+				const T sigma = this->stdev();
+				return this->_m3 / T(this->_count) / (sigma*sigma*sigma);
+			}
+
+			/// Sample excess kurtosis \f$\frac{1}{n}\sum(x_i-\mu)^4/\sigma^4-3\f$.
+			inline T
+			kurtosis() const noexcept {
+				const T var = this->variance();
+				return this->_m4 / T(this->_count) / (var*var) - T(3);
+			}
+
+		};
+
+		/// Accumulates moments of all array elements.
+		template <class T, int N>
+		Moments<T>
+		moments(const blitz::Array<T,N>& rhs) {
+			Moments<T> result;
+			for (const T& x : rhs) {
+				result.push(x);
+			}
+			return result;
+		}
+
+	}
+
+}
+
+#endif // STATS_MOMENTS_HH
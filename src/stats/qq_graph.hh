@@ -4,6 +4,7 @@
 #include <blitz/array.h>
 #include <algorithm>
 
+#include "quantile_sketch.hh"
 #include "statistics.hh"
 
 namespace arma {
@@ -14,26 +15,37 @@ namespace arma {
 		template <class T>
 		struct QQ_graph {
 
-			template <int N, class D>
-			QQ_graph(D dist, blitz::Array<T, N> rhs, size_t nquantiles = 100):
+			/**
+			Real quantiles are estimated from the sketch of the data,
+			hence the data is not copied and sorted.
+			*/
+			template <class D>
+			QQ_graph(
+				D dist,
+				const Quantile_sketch<T>& sketch,
+				size_t nquantiles = 100
+			):
 			_expected(nquantiles),
 			_real(nquantiles)
 			{
-				blitz::Array<T, N> data = rhs.copy();
 				/// 1. Calculate expected quantile values from supplied quantile
-				/// function.
+				/// function for all points at once.
+				blitz::Array<T, 1> f(nquantiles);
 				for (size_t i = 0; i < nquantiles; ++i) {
-					const T f = T(1.0) / T(nquantiles - 1) * T(i);
-					_expected(i) = dist.quantile(f);
+					f(i) = T(1.0) / T(nquantiles - 1) * T(i);
 				}
-				/// 2. Calculate real quantiles from data.
-				std::sort(data.data(), data.data() + data.numElements());
+				dist.quantile(f.data(), _expected.data(), int(nquantiles));
+				/// 2. Calculate real quantiles from the sketch.
 				for (size_t i = 0; i < nquantiles; ++i) {
-					const T f = T(1.0) / T(nquantiles - 1) * T(i);
-					_real(i) = quantile(data, f);
+					_real(i) = sketch.quantile(f(i));
 				}
 			}
 
+			template <int N, class D>
+			QQ_graph(D dist, blitz::Array<T, N> rhs, size_t nquantiles = 100):
+			QQ_graph(dist, quantile_sketch(rhs), nquantiles)
+			{}
+
 			/// Calculate distance between two quantile vectors.
 			T
 			distance() const;
@@ -0,0 +1,233 @@
+#ifndef STATS_QUANTILE_SKETCH_HH
+#define STATS_QUANTILE_SKETCH_HH
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include <blitz/array.h>
+
+#include "physical_constants.hh"
+
+namespace arma {
+
+	namespace stats {
+
+		/**
+		\brief Mergeable approximation of the distribution of the data
+		which is used to estimate quantiles (merging t-digest).
+
+		The data is summarised by weighted centroids. The weight of
+		the centroids is small near the tails and large near
+		the median, the limits are given by the scale function
+		\f$k(q)=\frac{\delta}{2\pi}\arcsin(2q-1)\f$ \cite Dunning2021,
+		where \f$\delta\f$ is the compression. The points are collected
+		in the buffer, and when it is full they are sorted together with
+		the centroids and merged into the new centroids in one pass.
+		The number of centroids does not exceed \f$\delta\f$, hence
+		the memory does not depend on the number of points, and
+		sketches of disjoint parts of the data can be merged.
+		*/
+		template <class T>
+		class Quantile_sketch {
+
+			struct Centroid {
+				T mean;
+				/// The number of points.
+				size_t weight;
+			};
+
+			/// Compression \f$\delta\f$.
+			T _compression = T(200);
+			/// The total weight of centroids and the buffer.
+			size_t _weight = 0;
+			T _min = std::numeric_limits<T>::max();
+			T _max = std::numeric_limits<T>::lowest();
+			/// The centroids are merged lazily, before the first query.
+			mutable std::vector<Centroid> _centroids;
+			mutable std::vector<Centroid> _buffer;
+
+		public:
+
+			Quantile_sketch() = default;
+
+			inline explicit
+			Quantile_sketch(T compression):
+			_compression(compression)
+			{}
+
+			inline void
+			push(T x) {
+				this->_buffer.push_back(Centroid{x, 1});
+				++this->_weight;
+				this->_min = std::min(this->_min, x);
+				this->_max = std::max(this->_max, x);
+				if (this->_buffer.size() >= this->buffer_size()) {
+					this->compress();
+				}
+			}
+
+			Quantile_sketch&
+			operator+=(const Quantile_sketch& rhs) {
+				this->_buffer.insert(
+					this->_buffer.end(),
+					rhs._centroids.begin(),
+					rhs._centroids.end()
+				);
+				this->_buffer.insert(
+					this->_buffer.end(),
+					rhs._buffer.begin(),
+					rhs._buffer.end()
+				);
+				this->_weight += rhs._weight;
+				this->_min = std::min(this->_min, rhs._min);
+				this->_max = std::max(this->_max, rhs._max);
+				this->compress();
+				return *this;
+			}
+
+			/**
+			\brief Estimates quantile by interpolating between
+			the centroids.
+			\param[in] f probability from \f$[0,1]\f$
+			*/
+			T
+			quantile(T f) const {
+				this->compress();
+				const std::vector<Centroid>& c = this->_centroids;
+				const int n = c.size();
+				if (n == 0) {
+					return std::numeric_limits<T>::quiet_NaN();
+				}
+				const T total = T(this->_weight);
+				const T index = f*total;
+				if (!(index > T(0))) {
+					return this->_min;
+				}
+				if (!(index < total)) {
+					return this->_max;
+				}
+				/// The left tail is interpolated between the minimum
+				/// and the first centroid.
+				T cum = T(0.5)*T(c[0].weight);
+				if (index < cum) {
+					return this->_min + (c[0].mean - this->_min)*index/cum;
+				}
+				for (int i=0; i<n-1; ++i) {
+					const T dw = T(0.5)*T(c[i].weight + c[i+1].weight);
+					if (index < cum + dw) {
+						return c[i].mean + (c[i+1].mean - c[i].mean)*(index - cum)/dw;
+					}
+					cum += dw;
+				}
+				/// The right tail is interpolated between the last centroid
+				/// and the maximum.
+				const T rest = total - cum;
+				return c[n-1].mean + (this->_max - c[n-1].mean)*(index - cum)/rest;
+			}
+
+			/// The number of points.
+			inline size_t
+			weight() const noexcept {
+				return this->_weight;
+			}
+
+			inline T
+			min() const noexcept {
+				return this->_min;
+			}
+
+			inline T
+			max() const noexcept {
+				return this->_max;
+			}
+
+			/// The number of centroids after merging the buffer.
+			inline int
+			size() const {
+				this->compress();
+				return this->_centroids.size();
+			}
+
+		private:
+
+			inline size_t
+			buffer_size() const noexcept {
+				return size_t(10*this->_compression);
+			}
+
+			/// Scale function \f$k(q)\f$.
+			inline T
+			scale(T q) const noexcept {
+				using constants::_2pi;
+				return this->_compression/_2pi<T>*std::asin(T(2)*q - T(1));
+			}
+
+			/// Inverse scale function \f$q(k)\f$.
+			inline T
+			inverse_scale(T k) const noexcept {
+				using constants::_2pi;
+				const T k_max = T(0.25)*this->_compression;
+				return T(0.5)*(T(1) + std::sin(_2pi<T>*std::min(k, k_max)/this->_compression));
+			}
+
+			void
+			compress() const {
+				std::vector<Centroid>& buffer = this->_buffer;
+				if (buffer.empty()) {
+					return;
+				}
+				std::vector<Centroid>& centroids = this->_centroids;
+				buffer.insert(buffer.end(), centroids.begin(), centroids.end());
+				std::sort(
+					buffer.begin(),
+					buffer.end(),
+					[] (const Centroid& lhs, const Centroid& rhs) {
+						return lhs.mean < rhs.mean;
+					}
+				);
+				centroids.clear();
+				const T total = T(this->_weight);
+				const int n = buffer.size();
+				size_t weight_so_far = 0;
+				T weight_limit = total*this->inverse_scale(this->scale(T(0)) + T(1));
+				Centroid current = buffer[0];
+				for (int i=1; i<n; ++i) {
+					const Centroid& next = buffer[i];
+					const size_t new_weight = current.weight + next.weight;
+					if (T(weight_so_far + new_weight) <= weight_limit) {
+						current.weight = new_weight;
+						current.mean += (next.mean - current.mean)
+							*T(next.weight)/T(new_weight);
+					} else {
+						weight_so_far += current.weight;
+						centroids.push_back(current);
+						const T q = T(weight_so_far)/total;
+						weight_limit = total*this->inverse_scale(this->scale(q) + T(1));
+						current = next;
+					}
+				}
+				centroids.push_back(current);
+				buffer.clear();
+			}
+
+		};
+
+		/// Summarises all array elements.
+		template <class T, int N>
+		Quantile_sketch<T>
+		quantile_sketch(const blitz::Array<T,N>& rhs) {
+			Quantile_sketch<T> result;
+			for (const T& x : rhs) {
+				result.push(x);
+			}
+			return result;
+		}
+
+	}
+
+}
+
+#endif // STATS_QUANTILE_SKETCH_HH
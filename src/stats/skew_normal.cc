@@ -1,6 +1,76 @@
 #include "skew_normal.hh"
 #include "params.hh"
 
+#include <algorithm>
+
+namespace {
+
+	/**
+	The size of the buffers on the stack. Points are processed in batches
+	of this size to avoid heap allocations in the solver, which calls
+	these functions for every bisection step. The size is the same as
+	the size of the batches of the solver.
+	*/
+	constexpr const int batch_size = 64;
+
+}
+
+template <class T>
+void
+arma::stats::Skew_normal<T>::cdf(const T* x, T* result, int n) const {
+	using arma::apmath::owen_t;
+	const T m = _mean;
+	const T s = T(1) / _sigma;
+	for (int i0=0; i0<n; i0+=batch_size) {
+		const int nb = std::min(batch_size, n - i0);
+		const T* xb = x + i0;
+		T* rb = result + i0;
+		T z[batch_size], t[batch_size];
+		#if ARMA_OPENMP
+		#pragma omp simd
+		#endif
+		for (int i=0; i<nb; ++i) {
+			z[i] = (xb[i] - m)*s;
+		}
+		owen_t(z, _alpha, t, nb);
+		_gaussian.cdf(xb, rb, nb);
+		#if ARMA_OPENMP
+		#pragma omp simd
+		#endif
+		for (int i=0; i<nb; ++i) {
+			rb[i] -= T(2)*t[i];
+		}
+	}
+}
+
+template <class T>
+void
+arma::stats::Skew_normal<T>::pdf(const T* x, T* result, int n) const {
+	const T m = _mean;
+	const T s = _alpha / _sigma;
+	const Gaussian<T> standard(T(0), T(1));
+	for (int i0=0; i0<n; i0+=batch_size) {
+		const int nb = std::min(batch_size, n - i0);
+		const T* xb = x + i0;
+		T* rb = result + i0;
+		T z[batch_size], phi[batch_size];
+		#if ARMA_OPENMP
+		#pragma omp simd
+		#endif
+		for (int i=0; i<nb; ++i) {
+			z[i] = (xb[i] - m)*s;
+		}
+		standard.cdf(z, phi, nb);
+		_gaussian.pdf(xb, rb, nb);
+		#if ARMA_OPENMP
+		#pragma omp simd
+		#endif
+		for (int i=0; i<nb; ++i) {
+			rb[i] *= T(2)*phi[i];
+		}
+	}
+}
+
 template <class T>
 std::istream&
 arma::stats::operator>>(std::istream& in, Skew_normal<T>& rhs) {
@@ -22,6 +92,8 @@ arma::stats::operator<<(std::ostream& out, const Skew_normal<T>& rhs) {
 		<< ",alpha=" << rhs._alpha;
 }
 
+template class arma::stats::Skew_normal<ARMA_REAL_TYPE>;
+
 template std::istream&
 arma::stats::operator>>(std::istream& in, Skew_normal<ARMA_REAL_TYPE>& rhs);
 
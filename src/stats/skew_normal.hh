@@ -44,6 +44,21 @@ namespace arma {
 					- T(2)*owen_t((x - _mean)/_sigma, _alpha);
 			}
 
+			inline T
+			pdf(T x) const noexcept {
+				const T z = (x - _mean)/_sigma;
+				return T(2)*_gaussian.pdf(x)
+					*Gaussian<T>(T(0), T(1)).cdf(_alpha*z);
+			}
+
+			/// Computes CDF for each of \f$n\f$ points.
+			void
+			cdf(const T* x, T* result, int n) const;
+
+			/// Computes PDF for each of \f$n\f$ points.
+			void
+			pdf(const T* x, T* result, int n) const;
+
 			template <class X>
 			friend std::istream&
 			operator>>(std::istream& in, Skew_normal<X>& rhs);
@@ -3,10 +3,13 @@
 
 #include <cmath>
 #include <string>
+#include <utility>
 
 #include <blitz/array.h>
 
+#include "moments.hh"
 #include "qq_graph.hh"
+#include "quantile_sketch.hh"
 
 namespace arma {
 
@@ -24,9 +27,16 @@ namespace arma {
 		template <class T>
 		struct Summary {
 
-			template <int N, class D>
+			/**
+			The mean and the variance are taken from the moments,
+			and Q-Q graph is built from the sketch of the data.
+			Both are computed in one pass and can be merged, so that
+			the summary of large arrays is computed in parts.
+			*/
+			template <class D>
 			Summary(
-				blitz::Array<T, N> rhs,
+				const Moments<T>& moments,
+				const Quantile_sketch<T>& sketch,
 				T m,
 				T var,
 				D dist,
@@ -35,15 +45,36 @@ namespace arma {
 				T tolerance=T(0.1)
 			):
 			_expected_mean(m),
-			_mean(stats::mean(rhs)),
+			_mean(moments.mean()),
 			_expected_variance(var),
-			_variance(needsvariance ? stats::variance(rhs) : T(0)),
-			_graph(dist, rhs),
+			_variance(needsvariance ? moments.variance() : T(0)),
+			_graph(dist, sketch),
 			_name(name),
 			_needvariance(needsvariance),
 			_tolerance(tolerance)
 			{}
 
+			template <int N, class D>
+			Summary(
+				blitz::Array<T, N> rhs,
+				T m,
+				T var,
+				D dist,
+				std::string name,
+				bool needsvariance,
+				T tolerance=T(0.1)
+			):
+			Summary(
+				accumulate(rhs),
+				m,
+				var,
+				dist,
+				name,
+				needsvariance,
+				tolerance
+			)
+			{}
+
 			inline T
 			qdistance() const {
 				return this->_graph.distance();
@@ -109,6 +140,42 @@ namespace arma {
 			}
 
 		private:
+			typedef std::pair<Moments<T>,Quantile_sketch<T>> statistics_type;
+
+			template <class D>
+			Summary(
+				const statistics_type& rhs,
+				T m,
+				T var,
+				D dist,
+				std::string name,
+				bool needsvariance,
+				T tolerance
+			):
+			Summary(
+				rhs.first,
+				rhs.second,
+				m,
+				var,
+				dist,
+				name,
+				needsvariance,
+				tolerance
+			)
+			{}
+
+			/// Accumulates moments and quantile sketch in one pass.
+			template <int N>
+			static statistics_type
+			accumulate(const blitz::Array<T,N>& rhs) {
+				statistics_type result;
+				for (const T& x : rhs) {
+					result.first.push(x);
+					result.second.push(x);
+				}
+				return result;
+			}
+
 			T _expected_mean;
 			T _mean;
 			T _expected_variance;
@@ -136,6 +203,20 @@ namespace arma {
 			return Summary<T>(rhs, m, var, dist, name, true, tol);
 		}
 
+		template <class T, class D>
+		Summary<T>
+		make_summary(
+			const Moments<T>& moments,
+			const Quantile_sketch<T>& sketch,
+			T m,
+			T var,
+			D dist,
+			std::string name,
+			T tol
+		) {
+			return Summary<T>(moments, sketch, m, var, dist, name, true, tol);
+		}
+
 		template <class T, int N, class D>
 		Summary<T>
 		make_summary(
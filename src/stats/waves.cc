@@ -1,9 +1,14 @@
 #include "waves.hh"
 
+#include <algorithm>
 #include <ostream>
 #include <stdexcept>
+#if ARMA_OPENMP
+#include <omp.h>
+#endif
 
 #include "apmath/convolution.hh"
+#include "fourier.hh"
 #include "physical_constants.hh"
 #include "statistics.hh"
 
@@ -23,6 +28,94 @@ namespace {
 		lhs.insert(lhs.end(), rhs.begin(), rhs.end());
 	}
 
+	/**
+	Kernels with radius up to this value are applied directly,
+	larger kernels are applied with Fourier transforms.
+	*/
+	constexpr const int max_direct_radius = 32;
+
+	/**
+	Computes the same convolution as \link arma::stats::filter\endlink:
+	the result has the same length as the signal and is shifted by
+	the kernel radius. The signal is read with the stride, so that
+	lines of multidimensional arrays are filtered without copying.
+	*/
+	template <class T>
+	void
+	fir_filter(
+		const T* x,
+		const int n,
+		const int stride,
+		const T* kernel,
+		const int nk,
+		T* result
+	) {
+		const int n0 = std::min(nk-1, n);
+		for (int i=0; i<n0; ++i) {
+			T sum = 0;
+			for (int m=0; m<=i; ++m) {
+				sum += kernel[m]*x[(i-m)*stride];
+			}
+			result[i] = sum;
+		}
+		#if ARMA_OPENMP
+		#pragma omp simd
+		#endif
+		for (int i=n0; i<n; ++i) {
+			T sum = 0;
+			for (int m=0; m<nk; ++m) {
+				sum += kernel[m]*x[(i-m)*stride];
+			}
+			result[i] = sum;
+		}
+	}
+
+	/**
+	Convolves the line of \f$n\f$ points with the kernel and
+	preserves the range of elevation. The result is written to
+	contiguous array, the line is read with the stride.
+	*/
+	template <class T>
+	void
+	smooth_line(
+		const T* x,
+		const int n,
+		const int stride,
+		const arma::Array1D<T>& kernel,
+		arma::Array1D<T>& result
+	) {
+		const int nk = kernel.numElements();
+		if (nk <= 2*max_direct_radius + 1) {
+			fir_filter(x, n, stride, kernel.data(), nk, result.data());
+		} else {
+			arma::Array1D<T> line(n);
+			for (int i=0; i<n; ++i) {
+				line(i) = x[i*stride];
+			}
+			arma::Array1D<T> kernel_copy(nk);
+			std::copy_n(kernel.data(), nk, kernel_copy.data());
+			result = arma::stats::filter(line, kernel_copy);
+		}
+		T x_min = x[0], x_max = x[0];
+		T y_min = result(0), y_max = result(0);
+		for (int i=1; i<n; ++i) {
+			x_min = std::min(x_min, x[i*stride]);
+			x_max = std::max(x_max, x[i*stride]);
+			y_min = std::min(y_min, result(i));
+			y_max = std::max(y_max, result(i));
+		}
+		result *= (x_max - x_min) / (y_max - y_min);
+	}
+
+	/**
+	Extracts waves from each line of the surface along the dimension.
+	Lines are processed in parallel, and the waves are collected
+	in per-thread vectors which are concatenated in thread order.
+	With static schedule the order is the same as in serial loop.
+	The lines are accessed via raw pointers and strides instead of
+	Blitz views, because each view locks the reference counter of
+	the array which is shared by all threads.
+	*/
 	template <class T>
 	arma::Array1D<arma::stats::Wave<T>>
 	extract_waves(
@@ -31,60 +124,64 @@ namespace {
 		int dimension,
 		int kradius
 	) {
-		using blitz::Range;
 		using arma::Domain;
 		using arma::stats::Wave;
+		using arma::stats::find_extrema;
 		using arma::stats::find_waves;
-		const int nt = elevation.extent(0);
-		const int nx = elevation.extent(1);
-		const int ny = elevation.extent(2);
+		if (dimension < 0 || dimension > 2) {
+			throw std::invalid_argument("bad dimension");
+		}
+		/// Dimensions of the lines' indices.
+		const int d0 = dimension == 0 ? 1 : 0;
+		const int d1 = dimension == 2 ? 1 : 2;
+		const int n = elevation.extent(dimension);
+		const int stride = elevation.stride(dimension);
+		const int n0 = elevation.extent(d0);
+		const int n1 = elevation.extent(d1);
+		const int stride0 = elevation.stride(d0);
+		const int stride1 = elevation.stride(d1);
+		const T* data = elevation.data();
 		Domain<T,1> grid1d {
 			{T(0)},
 			{grid.length(dimension)},
 			{grid.num_points(dimension)}
 		};
-		std::vector<Wave<T>> result;
-		if (dimension == 0) {
-			for (int i = 0; i < nx; ++i) {
-				for (int j = 0; j < ny; ++j) {
-					push_back_all(
-						result,
-						find_waves(
-							arma::Array1D<T>(elevation(Range::all(), i, j)),
-							grid1d,
-							kradius
-						)
-					);
-				}
-			}
-		} else if (dimension == 1) {
-			for (int i = 0; i < nt; ++i) {
-				for (int j = 0; j < ny; ++j) {
+		grid1d.translate({-kradius});
+		const arma::Array1D<T> kernel(arma::stats::gaussian_kernel<T>(kradius));
+		#if ARMA_OPENMP
+		const int nthreads = std::max(1, omp_get_max_threads());
+		#else
+		const int nthreads = 1;
+		#endif
+		std::vector<std::vector<Wave<T>>> thread_waves(nthreads);
+		#if ARMA_OPENMP
+		#pragma omp parallel num_threads(nthreads)
+		#endif
+		{
+			#if ARMA_OPENMP
+			std::vector<Wave<T>>& result = thread_waves[omp_get_thread_num()];
+			#else
+			std::vector<Wave<T>>& result = thread_waves[0];
+			#endif
+			const Domain<T,1> line_grid(grid1d);
+			arma::Array1D<T> smoothed(n);
+			#if ARMA_OPENMP
+			#pragma omp for collapse(2) schedule(static)
+			#endif
+			for (int i=0; i<n0; ++i) {
+				for (int j=0; j<n1; ++j) {
+					const T* line = data + i*stride0 + j*stride1;
+					smooth_line(line, n, stride, kernel, smoothed);
 					push_back_all(
 						result,
-						find_waves(
-							arma::Array1D<T>(elevation(i, Range::all(), j)),
-							grid1d,
-							kradius
-						)
+						find_waves(find_extrema(smoothed, line_grid))
 					);
 				}
 			}
-		} else if (dimension == 2) {
-			for (int i = 0; i < nt; ++i) {
-				for (int j = 0; j < nx; ++j) {
-					push_back_all(
-						result,
-						find_waves(
-							arma::Array1D<T>(elevation(i, j, Range::all())),
-							grid1d,
-							kradius
-						)
-					);
-				}
-			}
-		} else {
-			throw std::invalid_argument("bad dimension");
+		}
+		std::vector<Wave<T>> result;
+		for (const auto& waves : thread_waves) {
+			push_back_all(result, waves);
 		}
 		return to_waves(result);
 	}
@@ -196,9 +293,17 @@ template <class T>
 std::vector<arma::stats::Wave<T>>
 arma::stats
 ::find_waves(Array1D<T> elevation, Domain<T,1> grid, int r) {
-	Array1D<T> elevation_copy(elevation.copy());
-	smooth_elevation(elevation_copy, grid, r);
-	return find_waves(find_extrema(elevation_copy, grid));
+	const int n = elevation.numElements();
+	Array1D<T> smoothed(n);
+	smooth_line(
+		elevation.data(),
+		n,
+		elevation.stride(0),
+		gaussian_kernel<T>(r),
+		smoothed
+	);
+	grid.translate({-r});
+	return find_waves(find_extrema(smoothed, grid));
 }
 
 template <class T>
@@ -243,30 +348,156 @@ template <class T>
 void
 arma::stats
 ::smooth_elevation(Array1D<T>& elevation, Domain<T,1>& grid, int r) {
-	using blitz::scale;
-	arma::Array1D<T> new_elevation =
-		filter(elevation, gaussian_kernel<T>(r));
-	const T s = scale(elevation) / scale(new_elevation);
-	elevation = new_elevation * s;
+	const int n = elevation.numElements();
+	Array1D<T> new_elevation(n);
+	smooth_line(
+		elevation.data(),
+		n,
+		elevation.stride(0),
+		gaussian_kernel<T>(r),
+		new_elevation
+	);
+	elevation = new_elevation;
 	grid.translate({-r});
 }
 
 template <class T>
 arma::Array3D<T>
-arma::stats::frequency_amplitude_spectrum(Array3D<T> rhs, const Grid<T,3>& grid) {
+arma::stats::frequency_amplitude_spectrum(
+	Array3D<T> rhs,
+	const Grid<T,3>& grid,
+	Shape3D segment
+) {
 	using arma::apmath::Fourier_transform;
+	using arma::apmath::Fourier_direction;
+	using arma::constants::_2pi;
 	using blitz::RectDomain;
-	using blitz::abs;
 	using blitz::product;
-	using arma::constants::sqrt2pi;
 	typedef std::complex<T> C;
-	Array3D<C> rhs_copy(rhs.shape());
-	rhs_copy = rhs;
-	Fourier_transform<C,3> fft(rhs.shape());
-	fft.forward(rhs_copy);
-	const int n = rhs.numElements();
-	const RectDomain<3> domain(rhs.shape()/2, rhs.shape()-1);
-	return Array3D<T>(T(2) * abs(rhs_copy(domain)) / n);
+	const Shape3D shape = rhs.shape();
+	segment = blitz::min(segment, shape);
+	if (!blitz::all(segment > 0)) {
+		throw std::length_error("bad segment shape");
+	}
+	/// 1. Place segments with 50% overlap in each dimension.
+	const Shape3D hop = blitz::max(1, segment/2);
+	const Shape3D nsegments = (shape - segment)/hop + 1;
+	const int ntotal = product(nsegments);
+	const int nsegments_12 = nsegments(1)*nsegments(2);
+	/// 2. Compute separable Hann window and its sum, which
+	/// is used to normalise the amplitudes.
+	Array3D<T> window(segment);
+	{
+		std::vector<Array1D<T>> w(3);
+		T norm = 1;
+		for (int d=0; d<3; ++d) {
+			const int n = segment(d);
+			w[d].resize(n);
+			for (int i=0; i<n; ++i) {
+				w[d](i) = n == 1 ? T(1) : T(0.5)*(T(1) - std::cos(_2pi<T>*i/n));
+			}
+			norm *= blitz::sum(w[d]);
+		}
+		blitz::firstIndex i;
+		blitz::secondIndex j;
+		blitz::thirdIndex k;
+		window = w[0](i)*w[1](j)*w[2](k) / norm;
+	}
+	const RectDomain<3> domain(segment/2, segment-1);
+	const Shape3D result_shape = segment - segment/2;
+	/// 3. Transform two real segments at once: the first one is put
+	/// into the real part, the second one is put into the imaginary
+	/// part, and their transforms are separated using the symmetry of
+	/// the transform of real signal. The plan is computed once and
+	/// shared by the threads, each thread has its own workspace.
+	Fourier_transform<C,3> fft(segment);
+	const int npairs = (ntotal + 1) / 2;
+	#if ARMA_OPENMP
+	const int nthreads = std::max(1, omp_get_max_threads());
+	#else
+	const int nthreads = 1;
+	#endif
+	std::vector<Array3D<T>> thread_sums(nthreads);
+	#if ARMA_OPENMP
+	#pragma omp parallel num_threads(nthreads)
+	#endif
+	{
+		#if ARMA_OPENMP
+		Array3D<T>& sum = thread_sums[omp_get_thread_num()];
+		#else
+		Array3D<T>& sum = thread_sums[0];
+		#endif
+		sum.resize(result_shape);
+		sum = 0;
+		Array3D<C> buffer(segment);
+		auto workspace = fft.new_workspace();
+		#if ARMA_OPENMP
+		#pragma omp for schedule(static)
+		#endif
+		for (int p=0; p<npairs; ++p) {
+			const int a = 2*p;
+			const int b = 2*p + 1;
+			const bool has_b = b < ntotal;
+			const Shape3D offset_a = hop*Shape3D(
+				a/nsegments_12,
+				(a/nsegments(2)) % nsegments(1),
+				a % nsegments(2)
+			);
+			const Shape3D offset_b = has_b
+				? Shape3D(hop*Shape3D(
+					b/nsegments_12,
+					(b/nsegments(2)) % nsegments(1),
+					b % nsegments(2)
+				))
+				: offset_a;
+			for (int i=0; i<segment(0); ++i) {
+				for (int j=0; j<segment(1); ++j) {
+					for (int k=0; k<segment(2); ++k) {
+						const T w = window(i,j,k);
+						const T x_a = rhs(
+							offset_a(0) + i,
+							offset_a(1) + j,
+							offset_a(2) + k
+						);
+						const T x_b = !has_b ? T(0) : rhs(
+							offset_b(0) + i,
+							offset_b(1) + j,
+							offset_b(2) + k
+						);
+						buffer(i,j,k) = C(w*x_a, w*x_b);
+					}
+				}
+			}
+			fft.transform(buffer, workspace, Fourier_direction::Forward);
+			for (int i=segment(0)/2; i<segment(0); ++i) {
+				for (int j=segment(1)/2; j<segment(1); ++j) {
+					for (int k=segment(2)/2; k<segment(2); ++k) {
+						const C z = buffer(i,j,k);
+						const C z_conj = std::conj(buffer(
+							(segment(0)-i) % segment(0),
+							(segment(1)-j) % segment(1),
+							(segment(2)-k) % segment(2)
+						));
+						const Shape3D out = Shape3D(i,j,k) - domain.lbound();
+						/// \f$|X_a|=|Z_k+\bar{Z}_{-k}|/2\f$,
+						/// \f$|X_b|=|Z_k-\bar{Z}_{-k}|/2\f$.
+						sum(out) += T(0.5)*std::abs(z + z_conj);
+						if (has_b) {
+							sum(out) += T(0.5)*std::abs(z - z_conj);
+						}
+					}
+				}
+			}
+		}
+	}
+	/// 4. Average the amplitudes.
+	Array3D<T> result(result_shape);
+	result = 0;
+	for (const Array3D<T>& sum : thread_sums) {
+		result += sum;
+	}
+	result *= T(2) / T(ntotal);
+	return result;
 }
 
 template class arma::stats::Wave<ARMA_REAL_TYPE>;
@@ -319,5 +550,6 @@ arma::stats::operator<<(
 template arma::Array3D<ARMA_REAL_TYPE>
 arma::stats::frequency_amplitude_spectrum(
 	Array3D<ARMA_REAL_TYPE> rhs,
-	const Grid<ARMA_REAL_TYPE, 3>& grid
+	const Grid<ARMA_REAL_TYPE, 3>& grid,
+	Shape3D segment
 );
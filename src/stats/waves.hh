@@ -221,9 +221,44 @@ namespace arma {
 			int r
 		);
 
+		/**
+		\brief
+		Estimate amplitudes of the harmonics of the surface with Welch
+		method.
+		\param rhs wavy surface elevation
+		\param grid the grid of the surface
+		\param segment the shape of the segments
+
+		The surface is divided into segments which overlap by a half
+		in each dimension. Each segment is multiplied by Hann window and
+		is transformed, and the amplitudes are averaged over all segments,
+		which reduces the variance of the estimate. The memory
+		does not depend on the size of the surface. The amplitudes are
+		normalised by the sum of the window, so that the harmonic with
+		unit amplitude has unit peak. The element with index \f$m\f$ of
+		the result corresponds to the harmonic \f$n/2+m\f$, where \f$n\f$
+		is the segment size.
+		*/
 		template <class T>
 		Array3D<T>
-		frequency_amplitude_spectrum(Array3D<T> rhs, const Grid<T,3>& grid);
+		frequency_amplitude_spectrum(
+			Array3D<T> rhs,
+			const Grid<T,3>& grid,
+			Shape3D segment
+		);
+
+		/**
+		\brief
+		The same as \link frequency_amplitude_spectrum\endlink with the
+		segments of at most 64 points in each dimension.
+		*/
+		template <class T>
+		Array3D<T>
+		frequency_amplitude_spectrum(Array3D<T> rhs, const Grid<T,3>& grid) {
+			using blitz::min;
+			const Shape3D segment = min(rhs.shape(), Shape3D(64,64,64));
+			return frequency_amplitude_spectrum(rhs, grid, segment);
+		}
 
 	}
 
@@ -22,10 +22,18 @@ namespace arma {
 			{}
 
 			T
-			quantile(T f) {
+			quantile(T f) const {
 				return gsl_cdf_weibull_Pinv(f, _a, _b);
 			}
 
+			/// Computes quantile function for each of \f$n\f$ points.
+			void
+			quantile(const T* f, T* result, int n) const {
+				for (int i=0; i<n; ++i) {
+					result[i] = this->quantile(f[i]);
+				}
+			}
+
 		private:
 			T _a; //< lambda
 			T _b; //< k
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include "conjugate_gradient.hh"
+#include "whittle.hh"
+
+typedef ARMA_REAL_TYPE T;
+
+arma::Array3D<T>
+standing_wave_ACF(blitz::TinyVector<int,3> shape) {
+	using blitz::exp;
+	using blitz::cos;
+	blitz::firstIndex t;
+	blitz::secondIndex x;
+	blitz::thirdIndex y;
+	arma::Array3D<T> acf(shape);
+	acf = exp(-T(0.06)*(2*t + x + y)) * cos(T(1.6)*t) * cos(T(0.8)*x);
+	return acf;
+}
+
+class ConjugateGradientTest:
+public ::testing::TestWithParam<arma::Shape3D> {};
+
+TEST_P(ConjugateGradientTest, CompareToWhittle) {
+	using blitz::abs;
+	using blitz::all;
+	using blitz::max;
+	using blitz::product;
+	const arma::Shape3D order = GetParam();
+	arma::Array3D<T> acf(standing_wave_ACF(order));
+	arma::Conjugate_gradient_solver<T> solver(acf, order);
+	solver.residual(T(1e-12));
+	arma::Array3D<T> actual = solver.solve();
+	arma::Whittle_solver<T> whittle(acf, order);
+	arma::Array3D<T> expected = whittle.solve();
+	ASSERT_TRUE(all(actual.shape() == order));
+	EXPECT_NEAR(max(abs(actual - expected)), 0, T(1e-8))
+		<< "actual=" << actual << std::endl
+		<< "expected=" << expected << std::endl;
+	EXPECT_NEAR(
+		solver.white_noise_variance(),
+		whittle.white_noise_variance(),
+		T(1e-8)
+	);
+	EXPECT_LE(solver.num_iterations(), product(order));
+}
+
+INSTANTIATE_TEST_CASE_P(
+	StandingWaveACF,
+	ConjugateGradientTest,
+	::testing::Values(
+		arma::Shape3D(1,3,3),
+		arma::Shape3D(4,1,1),
+		arma::Shape3D(3,4,2),
+		arma::Shape3D(7,7,7),
+		arma::Shape3D(10,10,10)
+	)
+);
+
+TEST(ConjugateGradientTest, MaxIterations) {
+	const arma::Shape3D order(7,7,7);
+	arma::Array3D<T> acf(standing_wave_ACF(order));
+	arma::Conjugate_gradient_solver<T> solver(acf, order);
+	solver.max_iterations(2);
+	EXPECT_THROW(solver.solve(), std::runtime_error);
+	EXPECT_EQ(solver.num_iterations(), 2);
+}
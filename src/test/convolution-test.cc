@@ -291,6 +291,13 @@ INSTANTIATE_TEST_CASE_P(
 			shape(100,8,8),
 			shape(8,8,8)
 		},
+		// multiple blocks in each dimension
+		ConvolutionParams<3>{
+			shape(8,8,8),
+			shape(50,40,30),
+			shape(16,16,16),
+			shape(8,8,8)
+		},
 		// 2 dimensions
 		ConvolutionParams<3>{
 			shape(8,8,1),
@@ -308,6 +315,32 @@ INSTANTIATE_TEST_CASE_P(
 	)
 );
 
+#if !ARMA_OPENCL
+TEST(ConvolutionTest, ReuseKernelSpectrum) {
+	typedef arma::apmath::Convolution<C,3> convolution_type;
+	typedef typename convolution_type::array_type array_type;
+	using blitz::max;
+	using blitz::abs;
+	array_type kernel(shape(8,4,4));
+	std::mt19937 prng;
+	std::normal_distribution<T> normal(T(0), std::sqrt(T(2)));
+	std::generate(kernel.begin(), kernel.end(), std::bind(normal, prng));
+	array_type signal(shape(100,20,20));
+	array_type output(signal.shape());
+	convolution_type conv(signal, kernel);
+	for (int i=0; i<3; ++i) {
+		std::generate(signal.begin(), signal.end(), std::bind(normal, prng));
+		if (i == 2) {
+			// modify the kernel in place to invalidate the cached spectrum
+			kernel(0,0,0) += T(1);
+		}
+		reference_convolve(output, signal, kernel);
+		array_type actual(conv.convolve(signal, kernel));
+		EXPECT_NEAR(max(abs(actual - output)), 0, 1e-4) << "i=" << i;
+	}
+}
+#endif
+
 class Convolution2DTest:
 public ::testing::TestWithParam<ConvolutionParams<2>>
 {};
@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "apmath/direct_convolution.hh"
+#include "types.hh"
+
+using namespace arma;
+using blitz::shape;
+
+typedef ARMA_REAL_TYPE T;
+typedef apmath::Direct_convolution<T> convolution_type;
+
+void
+reference_convolve(Array3D<T>& zeta, Array3D<T>& eps, Array3D<T>& kernel) {
+	const Shape3D fsize = kernel.shape();
+	const int t1 = zeta.extent(0);
+	const int x1 = zeta.extent(1);
+	const int y1 = zeta.extent(2);
+	for (int t=0; t<t1; t++) {
+		for (int x=0; x<x1; x++) {
+			for (int y=0; y<y1; y++) {
+				const int m1 = std::min(t + 1, fsize[0]);
+				const int m2 = std::min(x + 1, fsize[1]);
+				const int m3 = std::min(y + 1, fsize[2]);
+				T sum = 0;
+				for (int k = 0; k < m1; k++)
+					for (int i = 0; i < m2; i++)
+						for (int j = 0; j < m3; j++)
+							sum += kernel(k, i, j) *
+								   eps(t - k, x - i, y - j);
+				zeta(t, x, y) = sum;
+			}
+		}
+	}
+}
+
+class DirectConvolutionTest:
+public ::testing::TestWithParam<std::tuple<Shape3D,Shape3D,bool>>
+{};
+
+TEST_P(DirectConvolutionTest, Reference) {
+	using blitz::abs;
+	using blitz::max;
+	using blitz::firstIndex;
+	using blitz::secondIndex;
+	using blitz::thirdIndex;
+	const Shape3D kernel_shape = std::get<0>(GetParam());
+	const Shape3D signal_shape = std::get<1>(GetParam());
+	const bool separable = std::get<2>(GetParam());
+	std::mt19937 prng;
+	std::normal_distribution<T> normal(T(0), T(1));
+	Array3D<T> kernel(kernel_shape);
+	if (separable) {
+		firstIndex i;
+		secondIndex j;
+		thirdIndex k;
+		kernel = (i+1)*exp(-T(0.5)*j)*cos(T(0.3)*k);
+	} else {
+		std::generate(kernel.begin(), kernel.end(), std::bind(normal, prng));
+	}
+	Array3D<T> signal(signal_shape);
+	std::generate(signal.begin(), signal.end(), std::bind(normal, prng));
+	Array3D<T> expected(signal_shape);
+	reference_convolve(expected, signal, kernel);
+	convolution_type conv(kernel);
+	EXPECT_EQ(separable, conv.separable());
+	Array3D<T> actual(conv.convolve(signal));
+	EXPECT_NEAR(max(abs(actual - expected)), 0, 1e-4);
+}
+
+INSTANTIATE_TEST_CASE_P(
+	Instance,
+	DirectConvolutionTest,
+	::testing::Values(
+		// one dimension
+		std::make_tuple(shape(8,1,1), shape(100,10,10), true),
+		std::make_tuple(shape(1,8,1), shape(10,100,10), true),
+		std::make_tuple(shape(1,1,8), shape(10,10,100), true),
+		// separable
+		std::make_tuple(shape(4,5,6), shape(20,20,20), true),
+		// general
+		std::make_tuple(shape(4,4,4), shape(20,20,20), false)
+	)
+);
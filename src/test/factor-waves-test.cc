@@ -6,6 +6,7 @@
 
 #include "apmath/convolution.hh"
 #include "domain.hh"
+#include "factor_waves.hh"
 #include "physical_constants.hh"
 #include "stats/waves.hh"
 
@@ -83,6 +84,26 @@ TEST(Waves, FeaturesRealWave) {
 	std::clog << "avg_length=" << avg_length << std::endl;
 }
 
+TEST(Waves, DirectFilter) {
+	using blitz::abs;
+	using blitz::max;
+	using blitz::scale;
+	arma::Array1D<T> elevation;
+	{
+		std::stringstream str;
+		str << str_slice_x;
+		str >> elevation;
+	}
+	const int n = elevation.numElements();
+	arma::Domain<T,1> grid({T(0)}, {T(209.44)}, {n});
+	arma::Array1D<T> expected =
+		arma::stats::filter(elevation, arma::stats::gaussian_kernel<T>(11));
+	expected *= scale(elevation) / scale(expected);
+	arma::Array1D<T> actual(elevation.copy());
+	arma::stats::smooth_elevation(actual, grid, 11);
+	EXPECT_NEAR(max(abs(actual - expected)), T(0), T(1e-5));
+}
+
 TEST(Waves, FrequencyAmplitudeSpectrum) {
 	using arma::Array3D;
 	using arma::Grid;
@@ -100,7 +121,8 @@ TEST(Waves, FrequencyAmplitudeSpectrum) {
 	const T amplitude = T(1);
 	signal = amplitude*blitz::cos(i*grid.delta(0) + _2pi<T>*(j/T(nj-1) + k/T(nk-1)));
 	{ std::ofstream("signal") << signal; }
-	Array3D<T> spectrum = arma::stats::frequency_amplitude_spectrum(signal, grid);
+	Array3D<T> spectrum =
+		arma::stats::frequency_amplitude_spectrum(signal, grid, grid.shape());
 	T avg_amplitude;
 	Shape3D idx;
 	auto max_elem = blitz::max_element(spectrum);
@@ -114,3 +136,51 @@ TEST(Waves, FrequencyAmplitudeSpectrum) {
 	EXPECT_NEAR(vec(1), grid.length(1), T(1e-3));
 	EXPECT_NEAR(vec(2), grid.length(2), T(1e-3));
 }
+
+TEST(Waves, FrequencyAmplitudeSpectrumWelch) {
+	using arma::Array3D;
+	using arma::Grid;
+	using arma::Shape3D;
+	using arma::constants::_2pi;
+	const int n = 96;
+	const int m = 32;
+	Grid<T,3> grid{{n,n,n},{T(n-1),T(n-1),T(n-1)}};
+	blitz::firstIndex i;
+	blitz::secondIndex j;
+	blitz::thirdIndex k;
+	Array3D<T> signal(grid.shape());
+	signal = blitz::cos(_2pi<T>*T(4)*(i + j + k)/T(m));
+	Array3D<T> spectrum =
+		arma::stats::frequency_amplitude_spectrum(signal, grid, Shape3D(m,m,m));
+	EXPECT_TRUE(blitz::all(spectrum.shape() == Shape3D(m/2,m/2,m/2)));
+	auto max_elem = blitz::max_element(spectrum);
+	const Shape3D idx = max_elem.position();
+	EXPECT_NEAR(*max_elem, T(1), T(1e-3));
+	EXPECT_TRUE(blitz::all(idx == Shape3D(m/2-4,m/2-4,m/2-4))) << "idx=" << idx;
+}
+
+TEST(Waves, WaveNumberRangeTranspose) {
+	const int nx = 64;
+	const int ny = 48;
+	blitz::firstIndex i;
+	blitz::secondIndex j;
+	arma::Array2D<T> z(nx, ny);
+	z = blitz::sin(T(0.3)*i)*blitz::cos(T(0.2)*j) + T(0.3)*blitz::sin(T(0.7)*i + T(1.1)*j);
+	arma::Wave_number_estimator<T> estimator;
+	const arma::Domain<T,2> range = estimator(z, 1, T(0.5));
+	/// the transposed slice is not contiguous and is copied
+	const arma::Domain<T,2> range_t = estimator(z.transpose(1, 0), 1, T(0.5));
+	/// the buffers are reused
+	const arma::Domain<T,2> range_2 = estimator(z, 1, T(0.5));
+	const arma::Domain<T,2> range_3 = arma::factor_waves(z, 1, T(0.5));
+	EXPECT_EQ(range.lbound(0), range_t.lbound(1));
+	EXPECT_EQ(range.lbound(1), range_t.lbound(0));
+	EXPECT_EQ(range.ubound(0), range_t.ubound(1));
+	EXPECT_EQ(range.ubound(1), range_t.ubound(0));
+	EXPECT_TRUE(blitz::all(range.lbound() == range_2.lbound()));
+	EXPECT_TRUE(blitz::all(range.ubound() == range_2.ubound()));
+	EXPECT_TRUE(blitz::all(range.lbound() == range_3.lbound()));
+	EXPECT_TRUE(blitz::all(range.ubound() == range_3.ubound()));
+	EXPECT_GT(range.lbound(0), T(0));
+	EXPECT_LE(range.lbound(0), range.ubound(0));
+}
@@ -12,3 +12,27 @@ TEST(FourierTest, Shape) {
 	EXPECT_TRUE(all(orig == fft.shape()));
 }
 
+
+TEST(FourierTest, ParallelTransform) {
+	typedef std::complex<double> T;
+	typedef arma::apmath::Fourier_transform<T,3> fft_type;
+	typedef typename fft_type::shape_type shape_type;
+	typedef typename fft_type::array_type array_type;
+	using blitz::abs;
+	using blitz::max;
+	const shape_type shape(12, 10, 14);
+	array_type expected(shape), actual(shape);
+	blitz::firstIndex i;
+	blitz::secondIndex j;
+	blitz::thirdIndex k;
+	expected = T(1)*blitz::sin(0.3*i + 0.7*j*k) + T(0,1)*blitz::cos(i*j + 0.1*k);
+	actual = expected;
+	fft_type fft(shape);
+	auto workspace = fft.new_workspace();
+	fft.forward(expected, workspace);
+	fft.forward(actual);
+	EXPECT_NEAR(max(abs(actual - expected)), 0, 1e-10);
+	fft.backward(expected, workspace);
+	fft.backward(actual);
+	EXPECT_NEAR(max(abs(actual - expected)), 0, 1e-10);
+}
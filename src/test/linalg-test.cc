@@ -87,3 +87,25 @@ TEST(Inverse, Matrix2) {
 	EXPECT_NEAR(lhs(1,0), T(1.5), T(1e-3));
 	EXPECT_NEAR(lhs(1,1), T(-0.5), T(1e-3));
 }
+
+TEST(LUFactorisation, SolveMany) {
+	using blitz::abs;
+	using blitz::max;
+	typedef double T;
+	const int n = 7, nrhs = 5;
+	blitz::firstIndex i;
+	blitz::secondIndex j;
+	linalg::Matrix<T> A(blitz::shape(n, n));
+	A = 1.0 / (1.0 + blitz::abs(i - j)) + n*(i == j) + 0.1*i*(j == 0);
+	linalg::Matrix<T> B(blitz::shape(n, nrhs));
+	B = blitz::sin(1.0 + i + 0.5*j);
+	linalg::Matrix<T> X(B.copy());
+	linalg::LU_factorisation<T> lu(A);
+	lu.solve(X);
+	EXPECT_NEAR(max(abs(linalg::multiply(A, X) - B)), T(0), T(1e-10));
+	linalg::Vector<T> b(n);
+	b = 1.0 - 0.3*i;
+	linalg::Vector<T> x(b.copy());
+	lu.solve(x);
+	EXPECT_NEAR(max(abs(linalg::multiply_mv(A, x) - b)), T(0), T(1e-10));
+}
@@ -41,3 +41,36 @@ TEST(MACoefficientSolver, Simple) {
 	MA_coefficient_solver<T> solver(acf, order);
 	solver();
 }
+
+TEST(MACoefficientSolver, NewtonRaphson) {
+	using namespace arma::generator;
+	using namespace arma;
+	using blitz::abs;
+	using blitz::max;
+	Shape3D order(5,5,5);
+	Array3D<T> acf = propagating_wave_ACF<T>(order);
+	MA_coefficient_solver<T> solver(acf, order);
+	solver.algorithm(MA_algorithm::Newton_Raphson);
+	Array3D<T> theta = solver.solve();
+	ASSERT_TRUE(blitz::all(theta.shape() == order));
+	EXPECT_EQ(theta(0,0,0), T(-1));
+	/// Compute the ACF of the MA process and compare it to the original.
+	const T var_wn = solver.white_noise_variance(theta);
+	Array3D<T> actual(order);
+	for (int i=0; i<order(0); ++i) {
+		for (int j=0; j<order(1); ++j) {
+			for (int k=0; k<order(2); ++k) {
+				T sum = 0;
+				for (int i1=0; i1<order(0)-i; ++i1) {
+					for (int j1=0; j1<order(1)-j; ++j1) {
+						for (int k1=0; k1<order(2)-k; ++k1) {
+							sum += theta(i1,j1,k1)*theta(i1+i,j1+j,k1+k);
+						}
+					}
+				}
+				actual(i,j,k) = var_wn*sum;
+			}
+		}
+	}
+	EXPECT_NEAR(max(abs(actual - acf)), 0, T(1e-5));
+}
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "stats/moments.hh"
+#include "stats/statistics.hh"
+
+typedef ARMA_REAL_TYPE T;
+
+TEST(Moments, MergeEqualsGSL) {
+	const int n = 10000;
+	blitz::Array<T,1> x(n);
+	std::mt19937 prng;
+	std::normal_distribution<T> dist(T(10), T(2));
+	for (int i=0; i<n; ++i) {
+		x(i) = dist(prng);
+	}
+	arma::stats::Moments<T> m;
+	const int bounds[] = {0, 1, 777, 5000, n};
+	for (int i=0; i<4; ++i) {
+		const blitz::Range part(bounds[i], bounds[i+1]-1);
+		m += arma::stats::moments(x(part));
+	}
+	EXPECT_EQ(m.count(), size_t(n));
+	EXPECT_NEAR(m.mean(), arma::stats::mean(x), T(1e-4));
+	EXPECT_NEAR(m.variance(), arma::stats::variance(x), T(1e-3));
+	EXPECT_NEAR(m.skewness(), arma::stats::skew(x), T(1e-3));
+	EXPECT_NEAR(m.kurtosis(), arma::stats::kurtosis(x), T(1e-3));
+}
+
+TEST(Moments, Empty) {
+	arma::stats::Moments<T> m;
+	arma::stats::Moments<T> rhs;
+	rhs.push(T(3));
+	m += rhs;
+	EXPECT_EQ(m.count(), size_t(1));
+	EXPECT_EQ(m.mean(), T(3));
+	EXPECT_EQ(m.variance(), T(0));
+}
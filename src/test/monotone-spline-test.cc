@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "nonlinear/monotone_spline.hh"
+
+typedef ARMA_REAL_TYPE T;
+
+TEST(MonotoneSpline, Interpolates) {
+	const int n = 1001;
+	const T x0 = -5, x1 = 5;
+	blitz::Array<T,1> y(n);
+	for (int i=0; i<n; ++i) {
+		y(i) = std::tanh(x0 + (x1-x0)*i/(n-1));
+	}
+	arma::nonlinear::Monotone_spline<T> spline(x0, x1, y);
+	for (int i=0; i<n; ++i) {
+		const T x = x0 + (x1-x0)*i/(n-1);
+		EXPECT_NEAR(spline(x), y(i), T(1e-6)) << "x=" << x;
+	}
+	for (int i=0; i<10*n; ++i) {
+		const T x = x0 + (x1-x0)*i/(10*n-1);
+		EXPECT_NEAR(spline(x), std::tanh(x), T(1e-5)) << "x=" << x;
+	}
+	EXPECT_TRUE(spline.contains(x0));
+	EXPECT_TRUE(spline.contains(x1));
+	EXPECT_FALSE(spline.contains(x1 + T(1e-3)));
+}
+
+TEST(MonotoneSpline, PreservesMonotonicity) {
+	blitz::Array<T,1> y(6);
+	y = 0, 0, 0, 1, 1, 1;
+	arma::nonlinear::Monotone_spline<T> spline(T(0), T(5), y);
+	T prev = spline(T(0));
+	for (int i=1; i<=500; ++i) {
+		const T curr = spline(T(0.01)*i);
+		EXPECT_GE(curr, prev);
+		EXPECT_GE(curr, T(0));
+		EXPECT_LE(curr, T(1));
+		prev = curr;
+	}
+}
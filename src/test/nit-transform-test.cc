@@ -0,0 +1,28 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "linalg.hh"
+#include "nonlinear/equations.hh"
+#include "nonlinear/transforms.hh"
+
+typedef ARMA_REAL_TYPE T;
+
+TEST(NITTransform, TransformACFNewtonMatchesBisection) {
+	using namespace arma::nonlinear;
+	blitz::Array<T,1> coefs(4);
+	coefs = 0, 1, T(0.3), T(0.1);
+	linalg::Bisection<T> solver(T(-10), T(10), T(1e-6), 100);
+	const int n = 1000;
+	std::vector<T> actual(n), expected(n);
+	for (int i=0; i<n; ++i) {
+		actual[i] = T(-0.9) + T(1.9)*i/(n-1);
+		expected[i] = solver(Equation_ACF<T>(coefs, actual[i]));
+	}
+	transform_ACF(actual.data(), n, coefs, solver);
+	for (int i=0; i<n; ++i) {
+		EXPECT_NEAR(actual[i], expected[i], T(1e-5)) << "i=" << i;
+		EXPECT_NEAR(Equation_ACF<T>(coefs, T(0))(actual[i]),
+			T(-0.9) + T(1.9)*i/(n-1), T(1e-5)) << "i=" << i;
+	}
+}
@@ -0,0 +1,285 @@
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gsl/gsl_errno.h>
+
+#include "arma_driver.hh"
+#include "config.hh"
+#include "register_all.hh"
+#include "stats/gaussian.hh"
+#include "stats/moments.hh"
+#include "stats/qq_graph.hh"
+#include "stats/quantile_sketch.hh"
+#include "stats/statistics.hh"
+#include "stats/waves.hh"
+
+/**
+\file
+\brief Throughput and statistical accuracy regression test.
+
+Generates wavy surface for the input file and writes the throughput,
+peak memory usage and statistics of the surface to JSON file. The test
+fails, if the throughput or the statistics degrade beyond the thresholds
+either in comparison to the baseline (the file written by the previous
+run) or in comparison to the model. The test is skipped (exit code 77)
+if there are no parallel Mersenne Twisters configurations in the working
+directory.
+*/
+
+namespace {
+
+	typedef ARMA_REAL_TYPE T;
+	typedef std::chrono::high_resolution_clock clock_type;
+	typedef std::vector<std::pair<std::string,T>> record_type;
+
+	/// Exit code which means that the test is skipped.
+	const int exit_skip = 77;
+
+	/// Gives access to the model which is read from the input file.
+	class Perf_driver: public arma::ARMA_driver<T> {
+
+	public:
+		inline model_type*
+		model() noexcept {
+			return this->_model;
+		}
+
+	};
+
+	void
+	throw_gsl_error(
+		const char* reason,
+		const char* file,
+		int line,
+		int gsl_errno
+	) {
+		std::cerr << "GSL error: " << file << ':' << reason << '.' << std::endl;
+		throw std::runtime_error(reason);
+	}
+
+	/// Peak resident set size in kilobytes.
+	long
+	peak_rss() {
+		struct ::rusage usage{};
+		::getrusage(RUSAGE_SELF, &usage);
+		return usage.ru_maxrss;
+	}
+
+	T
+	mean_or_nan(const arma::Array1D<T>& rhs) {
+		return rhs.numElements() == 0
+			? std::numeric_limits<T>::quiet_NaN()
+			: arma::stats::mean(rhs);
+	}
+
+	void
+	write_json(std::ostream& out, const std::string& name, const record_type& rec) {
+		out.precision(std::numeric_limits<T>::max_digits10);
+		out << "{\n\t\"name\": \"" << name << '"';
+		for (const auto& kv : rec) {
+			out << ",\n\t\"" << kv.first << "\": ";
+			if (std::isfinite(kv.second)) {
+				out << kv.second;
+			} else {
+				out << "null";
+			}
+		}
+		out << "\n}\n";
+	}
+
+	/// Reads the value of the key from JSON written by write_json().
+	bool
+	read_json_value(const std::string& json, const std::string& key, T& value) {
+		const std::string pattern = '"' + key + "\":";
+		const size_t pos = json.find(pattern);
+		if (pos == std::string::npos) {
+			return false;
+		}
+		const char* first = json.c_str() + pos + pattern.size();
+		char* last = nullptr;
+		value = std::strtod(first, &last);
+		return last != first;
+	}
+
+	bool
+	check(const std::string& name, T value, T threshold, bool ok) {
+		std::clog
+			<< std::left << std::setw(25) << name
+			<< std::right << std::setw(15) << value
+			<< std::setw(15) << threshold
+			<< std::setw(10) << (ok ? "ok" : "wrong")
+			<< std::endl;
+		return ok;
+	}
+
+	void
+	usage(const char* argv0) {
+		std::cout
+			<< "usage: " << argv0
+			<< " [-h] [-o OUTPUT] [-b BASELINE] [-s MAX_SLOWDOWN]"
+			   " [-d MAX_DRIFT] [-v MAX_VARIANCE_ERROR] [-q MAX_QDISTANCE]"
+			   " INPUTFILE\n";
+	}
+
+}
+
+int
+main(int argc, char* argv[]) {
+	using namespace arma;
+	std::string output;
+	std::string baseline;
+	/// Max. relative decrease of throughput in comparison to the baseline.
+	T max_slowdown = T(0.25);
+	/// Max. deviation of statistics from the baseline.
+	T max_drift = T(0.05);
+	/// Max. relative deviation of the variance from the model ACF (disabled by default).
+	T max_variance_error = T(0);
+	/// Max. distance between quantiles of elevation and normal distribution
+	/// (disabled by default).
+	T max_qdistance = T(0);
+	int opt = 0;
+	while ((opt = ::getopt(argc, argv, "ho:b:s:d:v:q:")) != -1) {
+		switch (opt) {
+			case 'h': usage(argv[0]); return 0;
+			case 'o': output = ::optarg; break;
+			case 'b': baseline = ::optarg; break;
+			case 's': max_slowdown = std::atof(::optarg); break;
+			case 'd': max_drift = std::atof(::optarg); break;
+			case 'v': max_variance_error = std::atof(::optarg); break;
+			case 'q': max_qdistance = std::atof(::optarg); break;
+			default: usage(argv[0]); return 1;
+		}
+	}
+	if (argc - ::optind != 1) {
+		usage(argv[0]);
+		return 1;
+	}
+	const std::string input = argv[::optind];
+	std::string name = output.empty() ? input : output;
+	name = name.substr(name.find_last_of('/') + 1);
+	name = name.substr(0, name.find('.'));
+	if (!std::ifstream(MT_CONFIG_FILE).is_open()) {
+		std::clog << "Skipping \"" << name << "\": no \"" MT_CONFIG_FILE
+			"\" in the working directory, generate it with "
+			"arma-dcmt programme." << std::endl;
+		return exit_skip;
+	}
+	gsl_set_error_handler(throw_gsl_error);
+	#if ARMA_OPENCL
+	opencl::init();
+	#endif
+	/// 1. Generate wavy surface.
+	Perf_driver driver;
+	register_all_models<T>(driver);
+	register_all_solvers<T>(driver);
+	driver.open(input);
+	generator::Basic_model<T>* model = driver.model();
+	const auto t0 = clock_type::now();
+	Array3D<T> zeta(model->generate());
+	const auto t1 = clock_type::now();
+	const T seconds = std::chrono::duration<T>(t1 - t0).count();
+	const T npoints = zeta.numElements();
+	/// 2. Compute the statistics.
+	const stats::Moments<T> moments = stats::moments(zeta);
+	const stats::Quantile_sketch<T> sketch = stats::quantile_sketch(zeta);
+	const stats::QQ_graph<T> graph(
+		stats::Gaussian<T>(moments.mean(), moments.stdev()),
+		sketch
+	);
+	const stats::Wave_field<T> waves(zeta, model->grid(), 9);
+	T expected_variance = std::numeric_limits<T>::quiet_NaN();
+	typedef generator::Basic_ARMA_model<T> arma_model_type;
+	if (const auto* m = dynamic_cast<const arma_model_type*>(model)) {
+		expected_variance = m->acf()(0,0,0);
+	}
+	const record_type throughput = {
+		{"points", npoints},
+		{"seconds", seconds},
+		{"throughput", npoints / seconds},
+		{"peak_rss", T(peak_rss())},
+	};
+	const record_type statistics = {
+		{"mean", moments.mean()},
+		{"variance", moments.variance()},
+		{"skewness", moments.skewness()},
+		{"kurtosis", moments.kurtosis()},
+		{"qdistance", graph.distance()},
+		{"wave_height_x_mean", mean_or_nan(waves.heights_x())},
+		{"wave_height_y_mean", mean_or_nan(waves.heights_y())},
+		{"wave_period_mean", mean_or_nan(waves.periods())},
+	};
+	record_type all(throughput);
+	all.insert(all.end(), statistics.begin(), statistics.end());
+	all.emplace_back("expected_variance", expected_variance);
+	write_json(std::cout, name, all);
+	if (!output.empty()) {
+		std::ofstream out(output);
+		write_json(out, name, all);
+	}
+	/// 3. Compare with the model and the baseline.
+	bool ok = true;
+	if (max_variance_error > T(0) && std::isfinite(expected_variance)) {
+		const T error = std::abs(moments.variance() - expected_variance)
+			/ expected_variance;
+		ok &= check("variance error", error, max_variance_error,
+			error <= max_variance_error);
+	}
+	if (max_qdistance > T(0)) {
+		ok &= check("qdistance", graph.distance(), max_qdistance,
+			graph.distance() <= max_qdistance);
+	}
+	if (!baseline.empty()) {
+		std::ifstream in(baseline);
+		if (!in.is_open()) {
+			std::clog << "No baseline \"" << baseline << "\"." << std::endl;
+		} else {
+			std::stringstream json;
+			json << in.rdbuf();
+			T base = 0;
+			if (read_json_value(json.str(), "throughput", base) && base > T(0)) {
+				const T slowdown = T(1) - (npoints / seconds) / base;
+				ok &= check("slowdown", slowdown, max_slowdown,
+					slowdown <= max_slowdown);
+			}
+			/// The mean is compared in the units of standard deviation,
+			/// skewness and kurtosis are already normalised and are
+			/// compared as is, since all of them are close to nought.
+			/// The other statistics are compared relative to the baseline.
+			const auto scale = [&moments] (const std::string& key, T base) {
+				if (key == "mean") {
+					return moments.stdev();
+				}
+				if (key == "skewness" || key == "kurtosis") {
+					return T(1);
+				}
+				return std::max(std::abs(base), std::numeric_limits<T>::epsilon());
+			};
+			for (const auto& kv : statistics) {
+				if (!read_json_value(json.str(), kv.first, base)
+					|| !std::isfinite(kv.second)) {
+					continue;
+				}
+				const T drift = std::abs(kv.second - base) / scale(kv.first, base);
+				ok &= check(kv.first + " drift", drift, max_drift, drift <= max_drift);
+			}
+		}
+	}
+	#if defined(ARMA_CLFFT)
+	clfftTeardown();
+	#endif
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "stats/quantile_sketch.hh"
+#include "stats/statistics.hh"
+
+typedef ARMA_REAL_TYPE T;
+
+TEST(QuantileSketch, CompareToSortedData) {
+	const int n = 100000;
+	const int nparts = 7;
+	blitz::Array<T,1> x(n);
+	std::mt19937 prng;
+	std::normal_distribution<T> dist(T(0), T(1));
+	std::vector<arma::stats::Quantile_sketch<T>> parts(nparts);
+	for (int i=0; i<n; ++i) {
+		x(i) = dist(prng);
+		parts[i % nparts].push(x(i));
+	}
+	arma::stats::Quantile_sketch<T> sketch;
+	for (const auto& part : parts) {
+		sketch += part;
+	}
+	EXPECT_EQ(sketch.weight(), size_t(n));
+	EXPECT_LE(sketch.size(), 200);
+	std::sort(x.data(), x.data() + n);
+	EXPECT_EQ(sketch.quantile(T(0)), x(0));
+	EXPECT_EQ(sketch.quantile(T(1)), x(n-1));
+	for (int i=1; i<100; ++i) {
+		const T f = T(i) / T(100);
+		EXPECT_NEAR(sketch.quantile(f), arma::stats::quantile(x, f), T(1e-2))
+			<< "f=" << f;
+	}
+}
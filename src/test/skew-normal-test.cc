@@ -1,5 +1,7 @@
+#include "stats/gram_charlier.hh"
 #include "stats/skew_normal.hh"
 #include <gtest/gtest.h>
+#include <vector>
 
 typedef ARMA_REAL_TYPE T;
 using arma::stats::Skew_normal;
@@ -17,3 +19,42 @@ TEST(SkewNormal, Identities) {
 	EXPECT_NEAR(sn.cdf(3), T(0.9973002039372995), eps);
 	EXPECT_NEAR(sn.cdf(4), T(0.9999366575163338), eps);
 }
+
+TEST(SkewNormal, Batch) {
+	Skew_normal<T> sn(T(0.5), T(2), T(3));
+	const int n = 101;
+	std::vector<T> x(n), cdf(n), pdf(n);
+	for (int i=0; i<n; ++i) {
+		x[i] = T(-8) + T(16)*i/(n-1);
+	}
+	sn.cdf(x.data(), cdf.data(), n);
+	sn.pdf(x.data(), pdf.data(), n);
+	for (int i=0; i<n; ++i) {
+		EXPECT_NEAR(cdf[i], sn.cdf(x[i]), T(1e-6)) << "x=" << x[i];
+		EXPECT_NEAR(pdf[i], sn.pdf(x[i]), T(1e-6)) << "x=" << x[i];
+	}
+	/// PDF is the derivative of CDF.
+	const T h = T(1e-3);
+	for (int i=0; i<n; ++i) {
+		const T dcdf = (sn.cdf(x[i]+h) - sn.cdf(x[i]-h)) / (T(2)*h);
+		EXPECT_NEAR(pdf[i], dcdf, T(1e-4)) << "x=" << x[i];
+	}
+}
+
+TEST(GramCharlier, Batch) {
+	using arma::stats::Gram_Charlier;
+	Gram_Charlier<T> gc(T(0.25), T(3.4));
+	const int n = 101;
+	std::vector<T> x(n), cdf(n), pdf(n);
+	for (int i=0; i<n; ++i) {
+		x[i] = T(-5) + T(10)*i/(n-1);
+	}
+	gc.cdf(x.data(), cdf.data(), n);
+	gc.pdf(x.data(), pdf.data(), n);
+	const T h = T(1e-3);
+	for (int i=0; i<n; ++i) {
+		EXPECT_NEAR(cdf[i], gc.cdf(x[i]), T(1e-6)) << "x=" << x[i];
+		const T dcdf = (gc.cdf(x[i]+h) - gc.cdf(x[i]-h)) / (T(2)*h);
+		EXPECT_NEAR(pdf[i], dcdf, T(1e-4)) << "x=" << x[i];
+	}
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <complex>
+
+#include "blitz.hh"
+#include "discrete_function.hh"
+#include "fourier.hh"
+#include "generator/spectral_model.hh"
+#include "grid.hh"
+#include "types.hh"
+
+typedef ARMA_REAL_TYPE T;
+typedef std::complex<T> C;
+
+arma::Discrete_function<T,3>
+gaussian_ACF(arma::Shape3D shape, T sigma) {
+	using namespace arma;
+	using blitz::exp;
+	blitz::firstIndex i;
+	blitz::secondIndex j;
+	blitz::thirdIndex k;
+	Array3D<T> tmp(shape);
+	tmp = exp(-(i*i + j*j + k*k) / (T(2)*sigma*sigma));
+	Discrete_function<T,3> acf;
+	acf.reference(tmp);
+	acf.setgrid(Grid<T,3>(shape));
+	return acf;
+}
+
+TEST(SpectralModel, FilterReproducesACF) {
+	using namespace arma;
+	using namespace arma::generator;
+	const Shape3D shape(16,20,24);
+	Discrete_function<T,3> acf = gaussian_ACF(Shape3D(6,6,6), T(1.5));
+	Spectral_model<T> model(acf);
+	model.setgrid(Grid<T,3>(shape));
+	model.determine_coefficients();
+	EXPECT_NO_THROW(model.validate());
+	/// Inverse transform of the squared filter is the ACF on the torus.
+	Array3D<C> r(shape);
+	r = blitz::pow2(model.filter());
+	apmath::Fourier_transform<C,3> fft(shape);
+	fft.backward(r);
+	r /= T(r.numElements());
+	for (int i=0; i<acf.extent(0); ++i) {
+		for (int j=0; j<acf.extent(1); ++j) {
+			for (int k=0; k<acf.extent(2); ++k) {
+				EXPECT_NEAR(std::real(r(i,j,k)), acf(i,j,k), T(1e-2))
+					<< "i=" << i << ",j=" << j << ",k=" << k;
+				EXPECT_NEAR(
+					std::real(r(
+						(shape(0)-i) % shape(0),
+						(shape(1)-j) % shape(1),
+						(shape(2)-k) % shape(2)
+					)),
+					acf(i,j,k),
+					T(1e-2)
+				) << "i=" << i << ",j=" << j << ",k=" << k;
+			}
+		}
+	}
+}
+
+TEST(SpectralModel, SmallGrid) {
+	using namespace arma;
+	using namespace arma::generator;
+	Spectral_model<T> model(gaussian_ACF(Shape3D(6,6,6), T(1.5)));
+	model.setgrid(Grid<T,3>(Shape3D(10,16,16)));
+	EXPECT_THROW(model.determine_coefficients(), std::length_error);
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <stdexcept>
+
+#include "arma.hh"
+#include "whittle.hh"
+
+typedef ARMA_REAL_TYPE T;
+
+TEST(StationarityTest, YuleWalkerSolution) {
+	using blitz::exp;
+	using blitz::cos;
+	const arma::Shape3D order(7,7,7);
+	blitz::firstIndex t;
+	blitz::secondIndex x;
+	blitz::thirdIndex y;
+	arma::Array3D<T> acf(order);
+	acf = exp(-T(0.06)*(2*t + x + y)) * cos(T(1.6)*t) * cos(T(0.8)*x);
+	arma::Whittle_solver<T> solver(acf, order);
+	arma::Array3D<T> phi = solver.solve();
+	EXPECT_NO_THROW(arma::validate_process_on_torus(phi));
+}
+
+TEST(StationarityTest, NonSeparable) {
+	arma::Array3D<T> phi(arma::Shape3D(2,2,2));
+	phi = 0;
+	phi(1,1,0) = T(0.9);
+	EXPECT_NO_THROW(arma::validate_process_on_torus(phi));
+}
+
+TEST(StationarityTest, ZeroOnGrid) {
+	arma::Array3D<T> phi(arma::Shape3D(2,2,1));
+	phi = 0;
+	phi(1,0,0) = T(0.5);
+	phi(0,1,0) = T(0.5);
+	EXPECT_THROW(arma::validate_process_on_torus(phi), std::runtime_error);
+}
+
+TEST(StationarityTest, ZeroBetweenGridPoints) {
+	arma::Array3D<T> phi(arma::Shape3D(3,1,1));
+	phi = 0;
+	phi(1,0,0) = T(2)*std::cos(T(0.1));
+	phi(2,0,0) = T(-1);
+	EXPECT_THROW(arma::validate_process_on_torus(phi), std::runtime_error);
+}
+
+TEST(StationarityTest, NearCritical) {
+	arma::Array3D<T> phi(arma::Shape3D(2,2,1));
+	phi = 0;
+	phi(1,1,0) = T(0.999);
+	EXPECT_NO_THROW(arma::validate_process_on_torus(phi));
+}
+
+/// \f$P(z_1,z_2)=1+z_1-z_2\f$ has zero on the torus between grid points,
+/// but \f$P(z,z)=1\f$ has no roots.
+TEST(StationarityTest, ZeroOnTorusOnly) {
+	arma::Array3D<T> phi(arma::Shape3D(2,2,1));
+	phi = 0;
+	phi(1,0,0) = T(-1);
+	phi(0,1,0) = T(1);
+	EXPECT_THROW(arma::validate_process_on_torus(phi), std::runtime_error);
+}
+
+TEST(StationarityTest, ZeroInsidePolydisc) {
+	arma::Array3D<T> phi(arma::Shape3D(2,1,1));
+	phi = 0;
+	phi(1,0,0) = T(1.5);
+	EXPECT_THROW(arma::validate_process_on_torus(phi), std::runtime_error);
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "generator/voodoo.hh"
+#include "linalg.hh"
+#include "whittle.hh"
+
+typedef ARMA_REAL_TYPE T;
+
+arma::Array3D<T>
+standing_wave_ACF(blitz::TinyVector<int,3> shape) {
+	using blitz::exp;
+	using blitz::cos;
+	blitz::firstIndex t;
+	blitz::secondIndex x;
+	blitz::thirdIndex y;
+	arma::Array3D<T> acf(shape);
+	acf = exp(-T(0.06)*(2*t + x + y)) * cos(T(1.6)*t) * cos(T(0.8)*x);
+	return acf;
+}
+
+arma::Array3D<T>
+solve_gauss_elimination(arma::Array3D<T> acf, arma::Shape3D order) {
+	using blitz::Range;
+	using blitz::toEnd;
+	arma::generator::AC_matrix_generator<T> gen(acf, order);
+	arma::Array2D<T> acm(gen());
+	const int m = acm.rows() - 1;
+	arma::Array1D<T> rhs(m);
+	rhs = acm(Range(1, toEnd), 0);
+	arma::Array2D<T> lhs(blitz::shape(m, m));
+	lhs = acm(Range(1, toEnd), Range(1, toEnd));
+	linalg::cholesky(lhs, rhs);
+	arma::Array3D<T> result(order);
+	result(0,0,0) = 0;
+	std::copy_n(rhs.data(), rhs.numElements(), result.data() + 1);
+	return result;
+}
+
+class WhittleTest: public ::testing::TestWithParam<arma::Shape3D> {};
+
+TEST_P(WhittleTest, CompareToGaussElimination) {
+	using blitz::abs;
+	using blitz::all;
+	using blitz::max;
+	using blitz::sum;
+	const arma::Shape3D order = GetParam();
+	arma::Array3D<T> acf(standing_wave_ACF(order));
+	arma::Whittle_solver<T> solver(acf, order);
+	arma::Array3D<T> actual = solver.solve();
+	arma::Array3D<T> expected = solve_gauss_elimination(acf, order);
+	ASSERT_TRUE(all(actual.shape() == order));
+	EXPECT_NEAR(max(abs(actual - expected)), 0, T(1e-8))
+		<< "actual=" << actual << std::endl
+		<< "expected=" << expected << std::endl;
+	EXPECT_NEAR(
+		solver.white_noise_variance(),
+		acf(0,0,0) - sum(expected*acf),
+		T(1e-8)
+	);
+}
+
+INSTANTIATE_TEST_CASE_P(
+	StandingWaveACF,
+	WhittleTest,
+	::testing::Values(
+		arma::Shape3D(1,3,3),
+		arma::Shape3D(4,1,1),
+		arma::Shape3D(2,2,2),
+		arma::Shape3D(3,4,2),
+		arma::Shape3D(7,7,7)
+	)
+);
+
+TEST(WhittleTest, BadOrder) {
+	arma::Array3D<T> acf(standing_wave_ACF(arma::Shape3D(3,3,3)));
+	EXPECT_THROW(
+		arma::Whittle_solver<T> solver(acf, arma::Shape3D(4,3,3)),
+		std::invalid_argument
+	);
+}
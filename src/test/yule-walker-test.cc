@@ -233,3 +233,18 @@ TEST(YuleWalkerTest, RealCase) {
 		<< "actual=" << actual << std::endl;
 }
 
+
+TEST(YuleWalkerTest, MaxResidual) {
+	using blitz::all;
+	using blitz::shape;
+	typedef ARMA_REAL_TYPE T;
+	YuleWalkerParams params{{10,10,10}, T(239.2780), T(1e-4), exponential_acf<T>, "exponential_acf"};
+	blitz::Array<T,3> acf(params.variance*params.generate_acf(params.order + 1));
+	arma::Yule_walker_solver<T> solver(acf);
+	solver.determine_the_order(false);
+	solver.chop(false);
+	solver.max_residual(T(1e-5));
+	auto actual = solver.solve();
+	EXPECT_TRUE(all(actual.shape() == shape(2,2,2)))
+		<< "actual=" << actual << std::endl;
+}
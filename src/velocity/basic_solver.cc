@@ -14,6 +14,7 @@ template<class T>
 void
 arma::velocity::Velocity_potential_solver<T>::write(std::ostream& out) const {
 	out << "wnmax=" << this->_wnmax << ','
+		<< "fixed_wnmax=" << this->_fixed_wnmax << ','
 		<< "depth=" << this->_depth << ','
 		<< "domain=" << this->_domain;
 }
@@ -25,6 +26,7 @@ arma::velocity::Velocity_potential_solver<T>::read(std::istream& in) {
 	using arma::validate_domain;
 	sys::parameter_map params({
 		{"wnmax", sys::make_param(_wnmax, validate_domain<T,2>)},
+		{"fixed_wnmax", sys::make_param(_fixed_wnmax)},
 		{"depth", sys::make_param(_depth, validate_finite<T>)},
 		{"domain", sys::make_param(_domain, validate_domain<T,2>)},
 	}, true);
@@ -48,6 +50,7 @@ arma::velocity::Velocity_potential_solver<T>::operator()(
 	const int nx = zeta_size(1);
 	const int ny = zeta_size(2);
 	Array4D<T> result(blitz::shape(nt, nz, nx, ny));
+	this->_wnmax_estimated = false;
 	precompute(zeta);
 	for (int i=0; i<nt; ++i) {
 		const T t = _domain(i, 0);
@@ -81,14 +84,14 @@ template <class T>
 void
 arma::velocity::Velocity_potential_solver<T>
 ::write(sys::pstream& out) const {
-	out << this->_wnmax << this->_depth << this->_domain;
+	out << this->_wnmax << this->_fixed_wnmax << this->_depth << this->_domain;
 }
 
 template <class T>
 void
 arma::velocity::Velocity_potential_solver<T>
 ::read(sys::pstream& in) {
-	in >> this->_wnmax >> this->_depth >> this->_domain;
+	in >> this->_wnmax >> this->_fixed_wnmax >> this->_depth >> this->_domain;
 }
 #endif
 
@@ -100,15 +103,21 @@ arma::velocity::Velocity_potential_solver<T>
 	const int idx_t
 ) {
 	using blitz::Range;
+	/// The range estimated for the first time slice is used for all of them.
+	if (this->_fixed_wnmax && this->_wnmax_estimated) {
+		return;
+	}
 	const T t = zeta.grid()(idx_t, 0);
 	const T dt = zeta.grid().delta(0);
-	domain2_type tmp = factor_waves<T>(
+	domain2_type tmp = this->_wnestimator(
 		zeta(idx_t, Range::all(), Range::all()),
 		t,
 		dt
 	);
-	this->_wnmax = domain2_type{{0,0}, T(1) / tmp.lbound(), {2,2}};
-	validate_domain<T,2>(this->_wnmax, "wnmax");
+	domain2_type wnmax{{0,0}, T(1) / tmp.lbound(), {2,2}};
+	validate_domain<T,2>(wnmax, "wnmax");
+	this->_wnmax = wnmax;
+	this->_wnmax_estimated = true;
 }
 
 template class arma::velocity::Velocity_potential_solver<ARMA_REAL_TYPE>;
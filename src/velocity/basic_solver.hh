@@ -12,6 +12,7 @@
 #include "types.hh"
 #include "domain.hh"
 #include "discrete_function.hh"
+#include "factor_waves.hh"
 
 namespace arma {
 
@@ -38,6 +39,14 @@ namespace arma {
 		protected:
 			/// Wave number range in \f$X\f$ and \f$Y\f$ dimensions.
 			domain2_type _wnmax;
+			/**
+			Whether wave number range is estimated once per run (from
+			the first time slice) or for each time slice of wavy surface.
+			*/
+			bool _fixed_wnmax = false;
+			/// Whether wave number range has been estimated in the current run.
+			bool _wnmax_estimated = false;
+			Wave_number_estimator<T> _wnestimator;
 			/// Water depth.
 			T _depth = 0;
 			domain2_type _domain;
@@ -1,7 +1,10 @@
 #ifndef WHITE_NOISE_HH
 #define WHITE_NOISE_HH
 
+#include <algorithm>
+#include <cassert>
 #include <cmath>
+#include <vector>
 #if ARMA_OPENMP
 #include <omp.h>
 #endif
@@ -14,32 +17,36 @@ namespace arma {
 
 	namespace prng {
 
+		/// Read parallel Mersenne Twister states, one for each thread.
+		inline std::vector<parallel_mt>
+		read_parallel_mts(bool noseed) {
+			#if ARMA_OPENMP
+			const size_t nthreads = std::max(1, omp_get_max_threads());
+			#else
+			const size_t nthreads = 1;
+			#endif
+			return read_parallel_mts(MT_CONFIG_FILE, nthreads, noseed);
+		}
+
 		/**
-		\brief Generate white noise via Mersenne Twister algorithm.
+		\brief Fill contiguous array with white noise using
+		Mersenne Twister states that are preserved between calls.
 
-		Convert to normal distribution via Box---Muller transform.
-		Uses parallel MT implementation if OpenMP is enabled.
+		Each thread uses its own generator from \p mts, hence the
+		sequence can be continued by subsequent calls (e.g. when the
+		surface is generated block by block).
 		*/
 		template <class T, int N, class Dist>
-		blitz::Array<T,N>
+		void
 		generate_white_noise(
-			const blitz::TinyVector<int,N>& shape,
-			bool noseed,
+			blitz::Array<T,N>& eps,
+			std::vector<parallel_mt>& mts,
 			Dist dist
 		) {
-			/// 1. Read parallel Mersenne Twister states.
-			#if ARMA_OPENMP
-			const size_t nthreads = std::max(1, omp_get_max_threads());
-			#else
-			const size_t nthreads = 1;
-			#endif
-			std::vector<parallel_mt> mts =
-				read_parallel_mts(MT_CONFIG_FILE, nthreads, noseed);
-			/// 2. Generate white noise in parallel.
-			blitz::Array<T,N> eps(shape);
+			assert(eps.isStorageContiguous());
 			const int n = eps.numElements();
 			#if ARMA_OPENMP
-			#pragma omp parallel
+			#pragma omp parallel firstprivate(dist)
 			#endif
 			{
 				#if ARMA_OPENMP
@@ -54,6 +61,26 @@ namespace arma {
 					eps.data()[i] = dist(mt);
 				}
 			}
+		}
+
+		/**
+		\brief Generate white noise via Mersenne Twister algorithm.
+
+		Convert to normal distribution via Box---Muller transform.
+		Uses parallel MT implementation if OpenMP is enabled.
+		*/
+		template <class T, int N, class Dist>
+		blitz::Array<T,N>
+		generate_white_noise(
+			const blitz::TinyVector<int,N>& shape,
+			bool noseed,
+			Dist dist
+		) {
+			/// 1. Read parallel Mersenne Twister states.
+			std::vector<parallel_mt> mts = read_parallel_mts(noseed);
+			/// 2. Generate white noise in parallel.
+			blitz::Array<T,N> eps(shape);
+			generate_white_noise(eps, mts, dist);
 			return eps;
 		}
 
@@ -0,0 +1,146 @@
+#include "whittle.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <vector>
+
+#include "linalg.hh"
+
+namespace {
+
+	template <class T>
+	using matrix_type = blitz::Array<T,2>;
+
+	template <class T>
+	using vector_type = blitz::Array<T,1>;
+
+	/**
+	Computes block \f$\Gamma_i\f$ of the autocovariance matrix
+	with elements \f$\gamma_{i,|j_1-j_2|,|k_1-k_2|}\f$.
+	*/
+	template <class T>
+	matrix_type<T>
+	gamma_block(const blitz::Array<T,3>& acf, int i, int nj, int nk) {
+		const int n = nj*nk;
+		matrix_type<T> result(blitz::shape(n, n));
+		for (int j1=0; j1<nj; ++j1) {
+			for (int k1=0; k1<nk; ++k1) {
+				for (int j2=0; j2<nj; ++j2) {
+					for (int k2=0; k2<nk; ++k2) {
+						result(j1*nk + k1, j2*nk + k2) =
+							acf(i, std::abs(j1-j2), std::abs(k1-k2));
+					}
+				}
+			}
+		}
+		return result;
+	}
+
+	template <class T>
+	inline matrix_type<T>
+	transpose(const matrix_type<T>& rhs) {
+		matrix_type<T> result(blitz::shape(rhs.cols(), rhs.rows()));
+		result = rhs.transpose(blitz::secondDim, blitz::firstDim);
+		return result;
+	}
+
+	/// Computes \f$A B^{-1}\f$ as \f$\left(B^{-T} A^T\right)^T\f$.
+	template <class T>
+	matrix_type<T>
+	right_divide(const matrix_type<T>& A, const matrix_type<T>& B) {
+		linalg::LU_factorisation<T> lu(transpose(B));
+		matrix_type<T> result(transpose(A));
+		lu.solve(result);
+		return transpose(result);
+	}
+
+}
+
+template <class T>
+arma::Whittle_solver<T>
+::Whittle_solver(array_type acf, Shape3D order):
+_acf(acf),
+_order(order) {
+	using blitz::all;
+	if (!all(order > 0) || !all(order <= acf.shape())) {
+		throw std::invalid_argument("bad AR model order");
+	}
+}
+
+template <class T>
+typename arma::Whittle_solver<T>::array_type
+arma::Whittle_solver<T>
+::solve() {
+	using linalg::multiply;
+	const int n0 = this->_order(0);
+	const int n1 = this->_order(1);
+	const int n2 = this->_order(2);
+	std::vector<matrix_type<T>> Gamma(n0);
+	for (int i=0; i<n0; ++i) {
+		Gamma[i].reference(gamma_block(this->_acf, i, n1, n2));
+	}
+	/**
+	Forward \f$\Phi_{n,i}\f$ and backward \f$\Psi_{n,i}\f$ predictor
+	coefficients of order \f$n\f$ and corresponding error covariances
+	\f$V_n\f$ and \f$U_n\f$. Coefficients of order \f$n-1\f$ are kept in
+	the second pair of vectors.
+	*/
+	std::vector<matrix_type<T>> Phi(n0), Psi(n0), Phi_prev(n0), Psi_prev(n0);
+	matrix_type<T> V(Gamma[0].copy());
+	matrix_type<T> U(Gamma[0].copy());
+	for (int n=1; n<n0; ++n) {
+		/**
+		\f$\Delta_{n-1} = \Gamma_n - \sum\limits_{i=1}^{n-1}\Phi_{n-1,i}\Gamma_{n-i}\f$
+		and
+		\f$\tilde{\Delta}_{n-1} = \Gamma_n - \sum\limits_{i=1}^{n-1}\Psi_{n-1,i}\Gamma_{n-i}\f$.
+		*/
+		matrix_type<T> Delta(Gamma[n].copy());
+		matrix_type<T> Delta_tilde(Gamma[n].copy());
+		for (int i=1; i<n; ++i) {
+			Delta -= multiply(Phi[i], Gamma[n-i]);
+			Delta_tilde -= multiply(Psi[i], Gamma[n-i]);
+		}
+		std::swap(Phi, Phi_prev);
+		std::swap(Psi, Psi_prev);
+		Phi[n].reference(right_divide(Delta, U));
+		Psi[n].reference(right_divide(Delta_tilde, V));
+		for (int i=1; i<n; ++i) {
+			Phi[i].reference(matrix_type<T>(
+				Phi_prev[i] - multiply(Phi[n], Psi_prev[n-i])
+			));
+			Psi[i].reference(matrix_type<T>(
+				Psi_prev[i] - multiply(Psi[n], Phi_prev[n-i])
+			));
+		}
+		V -= multiply(Phi[n], Delta_tilde);
+		U -= multiply(Psi[n], Delta);
+	}
+	/**
+	The first column of the inverse of the autocovariance matrix is
+	\f$\left(I,-\Phi_{p,1},\ldots,-\Phi_{p,p}\right)^T V_p^{-1} e_0\f$.
+	Dividing it by its first element gives the coefficients.
+	*/
+	vector_type<T> w(n1*n2);
+	w = 0;
+	w(0) = 1;
+	linalg::LU_factorisation<T>(V).solve(w);
+	if (!(w(0) > T(0))) {
+		throw std::runtime_error("autocovariance matrix is not positive definite");
+	}
+	array_type phi(this->_order);
+	std::copy_n(w.data(), w.numElements(), phi.data());
+	for (int i=1; i<n0; ++i) {
+		vector_type<T> a(
+			linalg::multiply_by_column_vector(transpose(Phi[i]), w)
+		);
+		std::copy_n(a.data(), a.numElements(), &phi(i,0,0));
+		phi(i,blitz::Range::all(),blitz::Range::all()) *= T(-1);
+	}
+	phi /= -w(0);
+	phi(0,0,0) = 0;
+	this->_varwn = T(1) / w(0);
+	return phi;
+}
+
+template class arma::Whittle_solver<ARMA_REAL_TYPE>;
@@ -0,0 +1,82 @@
+#ifndef WHITTLE_HH
+#define WHITTLE_HH
+
+#include "types.hh"
+
+namespace arma {
+
+	/**
+	\brief
+	Computes AR model coefficients using multichannel Levinson recursion
+	\cite Whittle1963.
+
+	Autocovariance matrix of the Yule---Walker system is
+	Toeplitz-block-Toeplitz: its block \f$(a,b)\f$ is matrix
+	\f$\Gamma_{|a-b|}\f$ with elements \f$\gamma_{|a-b|,|j_1-j_2|,|k_1-k_2|}\f$.
+	Each time slice of the wavy surface is treated as a vector of
+	\f$n_2 n_3\f$ channels, and forward and backward predictors are
+	computed recursively over the first dimension of the AR model order.
+	The algorithm takes \f$O(n_1^2 (n_2 n_3)^3)\f$ operations instead of
+	\f$O(n_1^3 (n_2 n_3)^3)\f$, and only blocks \f$\Gamma_0,\ldots,\Gamma_{n_1-1}\f$
+	are stored instead of the whole matrix.
+
+	Unlike \link Yule_walker_solver\endlink the order is not determined
+	automatically, and it may be different along each dimension.
+	*/
+	template <class T>
+	class Whittle_solver {
+
+	public:
+		/// Array element type.
+		typedef T value_type;
+		/// Three-dimensional array type.
+		typedef Array3D<T> array_type;
+
+	private:
+		/// Three-dimensional auto-covariance function \f$\gamma\f$.
+		array_type _acf;
+		/// AR model order.
+		Shape3D _order;
+		/// White noise variance, calculated by the algorithm.
+		T _varwn = T(0);
+
+	public:
+
+		/**
+		\param[in] acf three-dimensional auto-covariance function \f$\gamma\f$
+		\param[in] order AR model order
+		*/
+		Whittle_solver(array_type acf, Shape3D order);
+
+		~Whittle_solver() = default;
+
+		Whittle_solver(const Whittle_solver&) = delete;
+
+		Whittle_solver&
+		operator=(const Whittle_solver&) = delete;
+
+		/**
+		\brief Solve Yule---Walker system of equations.
+		\return three-dimensional array of coefficients with
+		\f$\varphi_{0,0,0}=0\f$
+		*/
+		array_type
+		solve();
+
+		/// \copydoc solve
+		inline array_type
+		operator()() {
+			return this->solve();
+		}
+
+		/// \copydoc _varwn
+		inline value_type
+		white_noise_variance() const noexcept {
+			return this->_varwn;
+		}
+
+	};
+
+}
+
+#endif // vim:filetype=cpp
@@ -2,9 +2,10 @@
 
 #include <algorithm>
 #include <cassert>
+#include <exception>
 #include <fstream>
 #include <stdexcept>
-#include <unordered_map>
+#include <vector>
 
 #ifndef NDEBUG
 #include <iostream>
@@ -39,13 +40,16 @@ namespace {
 	\right)\f$.
 	*/
 	template <class T>
-	inline blitz::Array<T,1>
-	rho_vector(int i, int j, int k, int d, const blitz::Array<T,3>& acf) {
+	inline void
+	rho_vector(
+		int i,
+		int j,
+		int k,
+		int d,
+		const blitz::Array<T,3>& acf,
+		T* data
+	) {
 		#define ACF(x,y,z) acf(std::abs(x), std::abs(y), std::abs(z))
-		typedef blitz::Array<T,1> vector_type;
-		using blitz::Range;
-		vector_type rho_ijkd(vector_shape(d));
-		T* data = rho_ijkd.data();
 		*data++ = ACF(i-d, j-d, k-d);
 		/**
 		Compute the first element, then for \f$e=1,\ldots,d\f$
@@ -118,6 +122,13 @@ namespace {
 			}
 		}
 		#undef ACF
+	}
+
+	template <class T>
+	inline blitz::Array<T,1>
+	rho_vector(int i, int j, int k, int d, const blitz::Array<T,3>& acf) {
+		blitz::Array<T,1> rho_ijkd(vector_shape(d));
+		rho_vector(i, j, k, d, acf, rho_ijkd.data());
 		return rho_ijkd;
 	}
 
@@ -145,10 +156,12 @@ namespace {
 	template <class T>
 	inline blitz::Array<T,2>
 	R_matrix(int a, int b, const blitz::Array<T,3>& acf) {
-		using blitz::Range;
 		typedef blitz::Array<T,2> matrix_type;
 		matrix_type R_ab(matrix_shape(a, b));
-		R_ab(0, Range::all()) = rho_vector(a, a, a, b, acf);
+		// rows are contiguous and are filled in place
+		#define ROW(i,j,k) rho_vector(i, j, k, b, acf, &R_ab(offset++, 0))
+		int offset = 0;
+		ROW(a, a, a);
 		/**
 		Compute the first row, then for \f$e=1,\ldots,a\f$
 		compute submatrices \f$R_{a,b;e} = \begin{bmatrix}
@@ -157,7 +170,6 @@ namespace {
 		R_{a,b;e}^{(6)}\\
 		\end{bmatrix}\f$ where
 		*/
-		int offset = 1;
 		for (int e=1; e<=a; ++e) {
 			/**
 			\f$R_{a,b;e}^{(1)} = \begin{bmatrix}
@@ -167,7 +179,7 @@ namespace {
 			\end{bmatrix}\f$,
 			*/
 			for (int idx=0; idx<e; ++idx) {
-				R_ab(offset++, Range::all()) = rho_vector(a-e, a-idx, a, b, acf);
+				ROW(a-e, a-idx, a);
 			}
 			/**
 			\f$R_{a,b;e}^{(2)} = \begin{bmatrix}
@@ -177,7 +189,7 @@ namespace {
 			\end{bmatrix}\f$,
 			*/
 			for (int idx=0; idx<e; ++idx) {
-				R_ab(offset++, Range::all()) = rho_vector(a-e+idx, a-e, a, b, acf);
+				ROW(a-e+idx, a-e, a);
 			}
 			/**
 			\f$R_{a,b;e}^{(3)} = \begin{bmatrix}
@@ -187,7 +199,7 @@ namespace {
 			\end{bmatrix}\f$,
 			*/
 			for (int idx=0; idx<e; ++idx) {
-				R_ab(offset++, Range::all()) = rho_vector(a, a-e, a-idx, b, acf);
+				ROW(a, a-e, a-idx);
 			}
 			/**
 			\f$R_{a,b;e}^{(4)} = \begin{bmatrix}
@@ -197,7 +209,7 @@ namespace {
 			\end{bmatrix}\f$,
 			*/
 			for (int idx=0; idx<e; ++idx) {
-				R_ab(offset++, Range::all()) = rho_vector(a, a-e+idx, a-e, b, acf);
+				ROW(a, a-e+idx, a-e);
 			}
 			/**
 			\f$R_{a,b;e}^{(5)} = \begin{bmatrix}
@@ -207,7 +219,7 @@ namespace {
 			\end{bmatrix}\f$,
 			*/
 			for (int idx=0; idx<e; ++idx) {
-				R_ab(offset++, Range::all()) = rho_vector(a-idx, a, a-e, b, acf);
+				ROW(a-idx, a, a-e);
 			}
 			/**
 			\f$R_{a,b;e}^{(6)} = \begin{bmatrix}
@@ -217,9 +229,10 @@ namespace {
 			\end{bmatrix}\f$.
 			*/
 			for (int idx=0; idx<e; ++idx) {
-				R_ab(offset++, Range::all()) = rho_vector(a-e, a, a-e+idx, b, acf);
+				ROW(a-e, a, a-e+idx);
 			}
 		}
+		#undef ROW
 		return R_ab;
 	}
 
@@ -352,6 +365,112 @@ namespace {
 		return result;
 	}
 
+	/**
+	Blocks \f$X_{a,b}\f$ with \f$a>b\geq1\f$ stored contiguously
+	in lower-triangular order.
+	*/
+	template <class X>
+	class Block_triangle {
+
+		std::vector<X> _blocks;
+
+	public:
+		/// \param[in] n the upper bound of the first index (inclusive)
+		inline explicit
+		Block_triangle(int n):
+		_blocks(std::max(0, n*(n-1)/2))
+		{}
+
+		inline X&
+		operator()(int a, int b) noexcept {
+			assert(1 <= b && b < a);
+			return this->_blocks[(a-1)*(a-2)/2 + b-1];
+		}
+
+	};
+
+	/**
+	Computes each block \f$R_{a,b}\f$, \f$a>b\f$ of Yule---Walker
+	matrix only once. Blocks above the diagonal are obtained from
+	symmetry \f$R_{a,b}=R_{b,a}^T\f$.
+	*/
+	template <class T>
+	class R_matrix_cache {
+
+	public:
+		typedef blitz::Array<T,2> matrix_type;
+
+	private:
+		const blitz::Array<T,3>& _acf;
+		Block_triangle<matrix_type> _blocks;
+
+	public:
+		inline
+		R_matrix_cache(const blitz::Array<T,3>& acf, int max_order):
+		_acf(acf),
+		_blocks(max_order)
+		{}
+
+		/// Returns \f$R_{a,b}\f$, \f$a>b\f$.
+		inline const matrix_type&
+		lower(int a, int b) {
+			matrix_type& R_ab = this->_blocks(a, b);
+			if (R_ab.numElements() == 0) {
+				R_ab.reference(R_matrix(a, b, this->_acf));
+			}
+			return R_ab;
+		}
+
+		/// Returns contiguous copy of \f$R_{a,b}\f$, \f$a<b\f$.
+		inline matrix_type
+		upper(int a, int b) {
+			const matrix_type& R_ba = this->lower(b, a);
+			matrix_type R_ab(blitz::shape(R_ba.cols(), R_ba.rows()));
+			R_ab = R_ba.transpose(blitz::secondDim, blitz::firstDim);
+			return R_ab;
+		}
+
+	};
+
+	/**
+	Computes maximal residual of Yule---Walker equations
+	\f$\max_{d\neq0}\left|\rho_d-\sum_p\varphi_p\rho_{d-p}\right|\f$
+	for all lags \f$d\f$ of the ACF, including the lags outside of
+	the order.
+	*/
+	template <class T>
+	T
+	acf_residual(const blitz::Array<T,3>& phi, const blitz::Array<T,3>& acf) {
+		#define ACF(x,y,z) acf(std::abs(x), std::abs(y), std::abs(z))
+		const int n0 = acf.extent(0);
+		const int n1 = acf.extent(1);
+		const int n2 = acf.extent(2);
+		const int m0 = phi.extent(0);
+		const int m1 = phi.extent(1);
+		const int m2 = phi.extent(2);
+		T result = 0;
+		for (int i=0; i<n0; ++i) {
+			for (int j=0; j<n1; ++j) {
+				for (int k=0; k<n2; ++k) {
+					if (i == 0 && j == 0 && k == 0) {
+						continue;
+					}
+					T sum = 0;
+					for (int l=0; l<m0; ++l) {
+						for (int m=0; m<m1; ++m) {
+							for (int s=0; s<m2; ++s) {
+								sum += phi(l,m,s)*ACF(i-l, j-m, k-s);
+							}
+						}
+					}
+					result = std::max(result, std::abs(acf(i,j,k) - sum));
+				}
+			}
+		}
+		#undef ACF
+		return result;
+	}
+
 	template <class T>
 	inline blitz::Array<T,2>
 	operator*(blitz::Array<T,2> lhs, blitz::Array<T,2> rhs) {
@@ -372,30 +491,88 @@ namespace {
 		return result;
 	}
 
-}
-
-namespace std {
-
-	template <>
-	struct hash<std::tuple<int,int>>: public std::hash<int> {
-		inline size_t
-		operator()(const std::tuple<int,int>& rhs) const noexcept {
-			typedef std::hash<int> base;
-			return base::operator()(std::get<0>(rhs)) ^
-				   base::operator()(std::get<1>(rhs));
+	/**
+	Saves the exception that is being handled to \p error, if no exception
+	has been saved yet. Exceptions can not propagate out of OpenMP tasks,
+	hence they are saved and rethrown when the tasks are finished.
+	*/
+	inline void
+	save_exception(std::exception_ptr& error) {
+		#if ARMA_OPENMP
+		#pragma omp critical(yule_walker_error)
+		#endif
+		{
+			if (!error) {
+				error = std::current_exception();
+			}
 		}
-	};
+	}
 
-	template <>
-	struct hash<std::tuple<int,int,int>>: public std::hash<int> {
-		inline size_t
-		operator()(const std::tuple<int,int,int>& rhs) const noexcept {
-			typedef std::hash<int> base;
-			return base::operator()(std::get<0>(rhs)) ^
-				   base::operator()(std::get<1>(rhs)) ^
-				   base::operator()(std::get<2>(rhs));
+	/**
+	Computes blocks \f$\Phi_{m+1,a,l-m}\f$, \f$a=1,\ldots,m\f$ from
+	blocks \f$\Phi_{m,a,l-m+1}\f$ computed in the previous step.
+	Matrix products are independent and are computed in parallel tasks.
+	*/
+	template <class T>
+	void
+	update_phi(
+		int m,
+		int l,
+		R_matrix_cache<T>& R,
+		Block_triangle<blitz::Array<T,2>>& Phi,
+		const std::vector<linalg::LU_factorisation<T>>& Theta,
+		std::vector<blitz::Array<T,2>>& Phi_m,
+		std::vector<blitz::Array<T,2>>& Phi_mp1
+	) {
+		typedef blitz::Array<T,2> matrix_type;
+		matrix_type R_m_lp1(R.upper(m, l+1));
+		std::vector<matrix_type> products(m);
+		std::exception_ptr error;
+		#if ARMA_OPENMP
+		#pragma omp taskgroup
+		#endif
+		{
+			for (int n=1; n<=m-1; ++n) {
+				#if ARMA_OPENMP
+				#pragma omp task default(shared) firstprivate(n)
+				#endif
+				try {
+					products[n].reference(R.lower(m,n)*Phi_m[n]);
+				} catch (...) {
+					save_exception(error);
+				}
+			}
 		}
-	};
+		if (error) {
+			std::rethrow_exception(error);
+		}
+		for (int n=1; n<=m-1; ++n) {
+			R_m_lp1 -= products[n];
+		}
+		Theta[m].solve(R_m_lp1);
+		Phi_mp1[m].reference(R_m_lp1);
+		#if ARMA_OPENMP
+		#pragma omp taskgroup
+		#endif
+		{
+			for (int a=1; a<=m-1; ++a) {
+				#if ARMA_OPENMP
+				#pragma omp task default(shared) firstprivate(a)
+				#endif
+				try {
+					Phi_mp1[a].reference(matrix_type(
+						Phi_m[a] - Phi(m,a)*Phi_mp1[m]
+					));
+				} catch (...) {
+					save_exception(error);
+				}
+			}
+		}
+		if (error) {
+			std::rethrow_exception(error);
+		}
+		std::swap(Phi_m, Phi_mp1);
+	}
 
 }
 
@@ -427,33 +604,37 @@ template <class T>
 typename arma::Yule_walker_solver<T>::array_type
 arma::Yule_walker_solver<T>
 ::solve() {
-	#define PHI(i,j,k) Phi[std::make_tuple(i,j,k)]
 	typedef blitz::Array<T,2> matrix_type;
 	typedef blitz::Array<T,1> vector_type;
-	typedef std::tuple<int,int,int> key_type;
-	typedef std::unordered_map<key_type,matrix_type> map3d_type;
 	using blitz::Range;
 	using blitz::shape;
 	using blitz::any;
 	/// Initial stage.
 	const int max_order = this->_maxorder;
-	map3d_type Phi;
+	R_matrix_cache<T> R(this->_acf, std::max(max_order, 2));
+	/**
+	Blocks \f$\Phi_{m,a,0}\f$ are used in all subsequent iterations,
+	whereas blocks \f$\Phi_{m,a,l-m+1}\f$ are computed and used only
+	in iteration \f$l\f$ when \f$\Phi_{m+1,a,l-m}\f$ are updated,
+	hence only two rows of them are stored.
+	*/
+	Block_triangle<matrix_type> Phi(std::max(max_order, 2));
+	std::vector<matrix_type> Phi_m(max_order+2);
+	std::vector<matrix_type> Phi_mp1(max_order+2);
 	blitz::Array<vector_type,1> Pi_l(shape(max_order+2));
 	blitz::Array<vector_type,1> Pi_lp1(shape(max_order+2));
-	blitz::Array<matrix_type,1> Theta(shape(max_order+2));
+	std::vector<linalg::LU_factorisation<T>> Theta(max_order+2);
 	matrix_type R_1_1 = R_matrix(1, 1, this->_acf);
 	vector_type R_1_0 = R_vector_b0(1, this->_acf);
 	vector_type R_0_1 = R_vector_a0(1, this->_acf);
 //	std::clog << "R_1_1=" << R_1_1 << std::endl;
 //	std::clog << "R_1_0=" << R_1_0 << std::endl;
 //	std::clog << "R_0_1=" << R_0_1 << std::endl;
-	matrix_type R_sup_1_1(R_1_1.shape());
-	R_sup_1_1 = R_1_1;
-	assert(linalg::is_symmetric(R_sup_1_1));
-	linalg::inverse(R_sup_1_1);
-//	std::clog << "R_1_1^{-1}=" << R_sup_1_1 << std::endl;
-//	std::clog << "R_1_1*R_1_1^{-1}=" << (R_1_1*R_sup_1_1) << std::endl;
-	vector_type Pi_2_1(linalg::multiply_mv(R_sup_1_1, R_1_0));
+	assert(linalg::is_symmetric(R_1_1));
+	/// Factorise \f$R_{1,1}\f$ once and use it instead of the inverse.
+	const linalg::LU_factorisation<T> R_sup_1_1(R_1_1);
+	vector_type Pi_2_1(R_1_0.copy());
+	R_sup_1_1.solve(Pi_2_1);
 //	std::clog << "Pi_2_1=" << Pi_2_1 << std::endl;
 	T lambda = T(1) - linalg::dot(R_0_1, Pi_2_1);
 	T var0 = this->_variance;
@@ -464,68 +645,129 @@ arma::Yule_walker_solver<T>
 			  << ",var=" << var << std::endl;
 //	#endif
 	Pi_l(1).reference(Pi_2_1);
-	PHI(2,1,0).reference(matrix_type(R_sup_1_1*R_matrix(1, 2, this->_acf)));
+	Phi(2,1).reference(R.upper(1, 2));
+	R_sup_1_1.solve(Phi(2,1));
 	bool changed = false;
+	bool fits = false;
 	int l = 1;
-	do {
-		++l;
-		var0 = var;
-		matrix_type R_l_l = R_matrix(l, l, this->_acf);
-		vector_type R_l_0 = R_vector_b0(l, this->_acf);
-		matrix_type sum1(R_l_l.shape());
-		sum1 = 0;
-		vector_type sum2(R_l_0.shape());
-		sum2 = 0;
-		for (int m=1; m<=l-1; ++m) {
-			matrix_type R_l_m(R_matrix(l, m, this->_acf));
-			sum1 += R_l_m*PHI(l,m,0);
-			sum2 += linalg::multiply_by_column_vector(R_l_m, Pi_l(m));
-		}
-		matrix_type Theta_l(R_l_l - sum1);
-		vector_type h_l(R_l_0 - sum2);
-//		std::clog << "h_l=" << h_l << std::endl;
-//		std::clog << "Theta_l=" << Theta_l << std::endl;
-		linalg::inverse(Theta_l);
-		Theta(l).reference(Theta_l);
-//		{ std::ifstream("/tmp/z") >> Theta_l; }
-//		std::clog << "Theta_l^{-1}=" << Theta_l << std::endl;
-		Pi_lp1(l).reference(linalg::multiply_mv(Theta_l, h_l));
-//		std::clog << "Pi(l+1,l)=" << Pi_lp1(l) << std::endl;
-		for (int a=1; a<=l-1; ++a) {
-			Pi_lp1(a).reference(vector_type(
-				Pi_l(a) - linalg::multiply_by_column_vector(PHI(l,a,0), Pi_lp1(l))
-			));
-		}
-		lambda -= linalg::dot(h_l, Pi_lp1(l));
-		var = this->_variance*lambda;
-		if (l < max_order) {
-			PHI(2,1,l-1).reference(R_sup_1_1*R_matrix(1, l+1, this->_acf));
-			for (int m=2; m<=l; ++m) {
-				matrix_type R_m_lp1(R_matrix(m,l+1,this->_acf));
-				matrix_type sum3(R_m_lp1.shape());
-				sum3 = 0;
-				for (int n=1; n<=m-1; ++n) {
-					sum3 += R_matrix(m,n,this->_acf)*PHI(m,n,l-m+1);
+	std::exception_ptr error;
+	/**
+	The recursion is expressed as a graph of tasks: blocks
+	\f$\Phi_{m+1,a,l-m}\f$, \f$m<l\f$ are computed concurrently with
+	\f$\Theta_l\f$, and independent matrix products inside each step
+	are computed in parallel.
+	*/
+	#if ARMA_OPENMP
+	#pragma omp parallel
+	#pragma omp single
+	#endif
+	try {
+		do {
+			++l;
+			var0 = var;
+			const bool update = l < max_order;
+			if (update) {
+				#if ARMA_OPENMP
+				#pragma omp task default(shared)
+				#endif
+				try {
+					Phi_m[1].reference(R.upper(1, l+1));
+					R_sup_1_1.solve(Phi_m[1]);
+					for (int m=2; m<=l-1; ++m) {
+						update_phi(m, l, R, Phi, Theta, Phi_m, Phi_mp1);
+					}
+				} catch (...) {
+					save_exception(error);
 				}
-				PHI(m+1,m,l-m).reference(Theta(m)*matrix_type(R_m_lp1 - sum3));
-				for (int a=1; a<=m-1; ++a) {
-					PHI(m+1,a,l-m).reference(matrix_type(
-						PHI(m,a,l-m+1) - PHI(m,a,0)*PHI(m+1,m,l-m)
-					));
+			}
+			matrix_type R_l_l = R_matrix(l, l, this->_acf);
+			vector_type R_l_0 = R_vector_b0(l, this->_acf);
+			std::vector<matrix_type> sum1(l);
+			std::vector<vector_type> sum2(l);
+			std::exception_ptr sum_error;
+			#if ARMA_OPENMP
+			#pragma omp taskgroup
+			#endif
+			{
+				for (int m=1; m<=l-1; ++m) {
+					#if ARMA_OPENMP
+					#pragma omp task default(shared) firstprivate(m)
+					#endif
+					try {
+						const matrix_type& R_l_m = R.lower(l, m);
+						sum1[m].reference(R_l_m*Phi(l,m));
+						sum2[m].reference(
+							linalg::multiply_by_column_vector(R_l_m, Pi_l(m))
+						);
+					} catch (...) {
+						save_exception(sum_error);
+					}
 				}
 			}
-		}
-		blitz::cycleArrays(Pi_l, Pi_lp1);
-//		#ifndef NDEBUG
-		/// Print solver state.
-		std::clog << __func__ << ':' << "order=" << l
-				  << ",var=" << var << std::endl;
-//		#endif
-		changed = !this->variance_has_not_changed_much(var, var0);
-	} while (l < max_order && changed);
-	#undef PHI
+			if (sum_error) {
+				std::rethrow_exception(sum_error);
+			}
+			for (int m=1; m<=l-1; ++m) {
+				R_l_l -= sum1[m];
+				R_l_0 -= sum2[m];
+			}
+			const vector_type& h_l = R_l_0;
+//			std::clog << "h_l=" << h_l << std::endl;
+//			std::clog << "Theta_l=" << R_l_l << std::endl;
+			Theta[l].factorise(R_l_l);
+			Pi_lp1(l).reference(h_l.copy());
+			Theta[l].solve(Pi_lp1(l));
+//			std::clog << "Pi(l+1,l)=" << Pi_lp1(l) << std::endl;
+			for (int a=1; a<=l-1; ++a) {
+				Pi_lp1(a).reference(vector_type(
+					Pi_l(a) - linalg::multiply_by_column_vector(Phi(l,a), Pi_lp1(l))
+				));
+			}
+			lambda -= linalg::dot(h_l, Pi_lp1(l));
+			var = this->_variance*lambda;
+			#if ARMA_OPENMP
+			#pragma omp taskwait
+			#endif
+			if (error) {
+				std::rethrow_exception(error);
+			}
+			if (update) {
+				/// The last step depends on \f$\Theta_l\f$.
+				update_phi(l, l, R, Phi, Theta, Phi_m, Phi_mp1);
+				/// Keep \f$\Phi_{l+1,a,0}\f$ for subsequent iterations.
+				for (int a=1; a<=l; ++a) {
+					Phi(l+1,a).reference(Phi_m[a]);
+				}
+			}
+			blitz::cycleArrays(Pi_l, Pi_lp1);
+//			#ifndef NDEBUG
+			/// Print solver state.
+			std::clog << __func__ << ':' << "order=" << l
+					  << ",var=" << var << std::endl;
+//			#endif
+			changed = !this->variance_has_not_changed_much(var, var0);
+			/**
+			Stop at the first order that reproduces the ACF
+			with the desired precision.
+			*/
+			if (this->_maxresidual > T(0)) {
+				const T residual = acf_residual(result_array(Pi_l, l), this->_acf);
+				std::clog << __func__ << ':' << "order=" << l
+						  << ",residual=" << residual << std::endl;
+				fits = residual < this->_maxresidual;
+			}
+		} while (l < max_order && changed && !fits);
+	} catch (...) {
+		#if ARMA_OPENMP
+		#pragma omp taskwait
+		#endif
+		save_exception(error);
+	}
+	if (error) {
+		std::rethrow_exception(error);
+	}
 	array_type result;
-	if (changed) {
+	if (changed || fits) {
 		this->_varwn = var;
 		result.reference(result_array(Pi_l, l));
 	} else {
@@ -64,6 +64,15 @@ namespace arma {
 		   resulting ACF.
 		 */
 		bool _chop = true;
+		/**
+		   \brief
+		   Maximum ACF residual. If positive, the order is increased until
+		   \f$\max_{d\neq0}\left|\rho_d-\sum_p\varphi_p\rho_{d-p}\right|
+		   <\epsilon_{\text{ACF}}\f$ for all lags \f$d\f$ of the ACF, i.e.
+		   until the smallest order that reproduces the whole ACF
+		   is found.
+		 */
+		T _maxresidual = T(0);
 		/// White noise variance, calculated by the algorithm.
 		T _varwn = T(0);
 
@@ -173,6 +182,17 @@ namespace arma {
 			this->_varepsilon = rhs;
 		}
 
+		/// \copydoc _maxresidual
+		inline value_type
+		max_residual() const noexcept {
+			return this->_maxresidual;
+		}
+
+		inline void
+		max_residual(value_type rhs) noexcept {
+			this->_maxresidual = rhs;
+		}
+
 		/// \copydoc _varwn
 		inline value_type
 		white_noise_variance() const noexcept {